@@ -0,0 +1,92 @@
+/*
+    This file is part of Jemu
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <stdint.h>
+
+namespace jemu {
+
+/** A pointer shared with one real-time reader thread, RCU style.
+
+    The reader enters a ReadScope, which costs two atomic increments and
+    never blocks. Writers publish a new pointer with exchange(), which waits
+    out the reader's current scope (the grace period) before handing the
+    old pointer back, so the caller may then delete it.
+
+    Only a single reader thread is supported, e.g. an audio device callback.
+    Writers must be serialized by the caller.
+*/
+template<typename T>
+class EpochPointer
+{
+public:
+    EpochPointer() = default;
+    EpochPointer (const EpochPointer&) = delete;
+    EpochPointer& operator= (const EpochPointer&) = delete;
+
+    /** Reader critical section. The pointer from get() stays valid until
+        the scope ends. */
+    class ReadScope
+    {
+    public:
+        explicit ReadScope (EpochPointer& p)
+            : owner (p)
+        {
+            // epoch is odd while the reader is inside a scope
+            owner.epoch.fetch_add (1, std::memory_order_seq_cst);
+            object = owner.pointer.load (std::memory_order_seq_cst);
+        }
+
+        ~ReadScope()
+        {
+            owner.epoch.fetch_add (1, std::memory_order_release);
+        }
+
+        inline T* get() const { return object; }
+
+    private:
+        EpochPointer& owner;
+        T* object = nullptr;
+        ReadScope (const ReadScope&) = delete;
+        ReadScope& operator= (const ReadScope&) = delete;
+    };
+
+    /** Returns the current pointer. Only safe on writer threads */
+    inline T* current() const { return pointer.load (std::memory_order_acquire); }
+
+    /** Publish a new pointer and wait for the reader to let go of the old
+        one. Returns the old pointer, which is no longer referenced. */
+    T* exchange (T* next)
+    {
+        T* const previous = pointer.exchange (next, std::memory_order_seq_cst);
+        const uint32_t seen = epoch.load (std::memory_order_seq_cst);
+        if ((seen & 1u) != 0)
+            while (epoch.load (std::memory_order_acquire) == seen)
+                std::this_thread::yield();
+        return previous;
+    }
+
+private:
+    std::atomic<T*> pointer { nullptr };
+    std::atomic<uint32_t> epoch { 0 };
+};
+
+}
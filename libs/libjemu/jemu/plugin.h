@@ -29,6 +29,13 @@ extern "C" {
 
 #define JEMU_PREFIX "org.jemu."
 #define JEMU_GAME_CORE          JEMU_PREFIX "GameCore"
+#define JEMU_GAME_CORE_TIMING   JEMU_PREFIX "GameCoreTiming"
+#define JEMU_GAME_CORE_AUDIO    JEMU_PREFIX "GameCoreAudio"
+#define JEMU_GAME_CORE_VIDEO    JEMU_PREFIX "GameCoreVideo"
+#define JEMU_GAME_CORE_BATCH    JEMU_PREFIX "GameCoreBatch"
+#define JEMU_GAME_CORE_CAPS     JEMU_PREFIX "GameCoreCaps"
+#define JEMU_GAME_CORE_STATE    JEMU_PREFIX "GameCoreState"
+#define JEMU_GAME_CORE_IDLE     JEMU_PREFIX "GameCoreIdle"
 #define JEMU_GAME_PAD           JEMU_PREFIX "GamePad"
 #define JEMU_GAME_PAD_SOURCE    JEMU_PREFIX "GamePadSource"
 #define JEMU_MFI                JEMU_PREFIX "MFI"
@@ -86,6 +93,134 @@ typedef struct _JemuGameCore {
     void (*button_press)(JemuHandle, const uint32_t button, const bool pressed);
 } JemuGameCore;
 
+typedef struct _JemuGameCoreTiming {
+    /** Emulated frames per second, e.g. 60.0988 for an NTSC NES */
+    double (*frame_rate)(JemuHandle);
+
+    /** Sample rate of the audio returned by read_audio */
+    double (*sample_rate)(JemuHandle);
+} JemuGameCoreTiming;
+
+typedef struct _JemuGameCoreAudio {
+    /** Rate at which the host reads read_audio, e.g. the audio device's.
+        The core resamples its sample_rate audio to it. Pass 0 to read at
+        sample_rate again. May be called from any thread */
+    void (*set_output_rate)(JemuHandle, double rate);
+} JemuGameCoreAudio;
+
+typedef enum {
+    /** 32 bits per pixel, native endian 0x00RRGGBB. The top byte is undefined */
+    JEMU_PIXEL_FORMAT_XRGB8888  = 0,
+
+    /** 16 bits per pixel, native endian RRRRRGGGGGGBBBBB */
+    JEMU_PIXEL_FORMAT_RGB565    = 1,
+
+    /** 32 bits per pixel, native endian 0x00BBGGRR. The top byte is undefined */
+    JEMU_PIXEL_FORMAT_XBGR8888  = 2,
+
+    /** 24 bits per pixel, 0xRRGGBB stored least significant byte first */
+    JEMU_PIXEL_FORMAT_RGB888    = 3
+} JemuPixelFormat;
+
+typedef struct _JemuVideoFormat {
+    /** One of JemuPixelFormat */
+    uint32_t pixel_format;
+
+    /** Frame size in pixels, must match what the core renders */
+    uint32_t width;
+    uint32_t height;
+
+    /** Bytes from the start of one row to the next */
+    int32_t pitch;
+} JemuVideoFormat;
+
+typedef struct _JemuGameCoreVideo {
+    /** Render frames straight into host memory. `buffers` holds three
+        frames laid out as described by `format`, which must stay valid
+        until this is called again or the core is released. Pass NULL
+        buffers to go back to the core's own video_frame buffer. Returns
+        false if the core can't render the format. */
+    bool (*set_frame_buffers)(JemuHandle, const JemuVideoFormat* format, void* const* buffers);
+
+    /** Returns the index of the newest completed host frame, or -1 if none
+        has been completed yet. The core won't write to that frame until the
+        next call. Lock-free, call it from a single consumer thread. */
+    int32_t (*acquire_frame)(JemuHandle);
+} JemuGameCoreVideo;
+
+/** Number of pads in a JemuInputFrame */
+#define JEMU_INPUT_FRAME_PADS 4
+
+typedef struct _JemuInputFrame {
+    /** Button state of each pad. Bit n is set while button n, as passed
+        to button_press, is held down */
+    uint32_t pads[JEMU_INPUT_FRAME_PADS];
+} JemuInputFrame;
+
+typedef enum {
+    /** Don't render video for all but the last frame */
+    JEMU_RUN_SKIP_VIDEO = 1 << 0,
+
+    /** Don't render audio for all but the last frame */
+    JEMU_RUN_SKIP_AUDIO = 1 << 1
+} JemuRunFlags;
+
+typedef struct _JemuGameCoreBatch {
+    /** Emulate `count` frames in one call. If `inputs` isn't NULL it holds
+        `count` input frames, one applied before each frame, and the last
+        one stays in effect afterwards. `flags` are JemuRunFlags; the last
+        frame always renders, so video_frame and read_audio see its output.
+        Returns the number of frames emulated. */
+    uint32_t (*run_frames)(JemuHandle, uint32_t count, const JemuInputFrame* inputs, uint32_t flags);
+} JemuGameCoreBatch;
+
+typedef struct _JemuGameCoreState {
+    /** Bytes save_state_into needs for the current state, or 0 if there is
+        nothing to save, e.g. no rom is loaded. Only changes when the loaded
+        game or machine configuration does */
+    uint32_t (*state_size)(JemuHandle);
+
+    /** Serialize the emulator into `size` bytes of caller owned memory.
+        Nothing is allocated and nothing is compressed, so a buffer sized
+        by state_size can be reused for any number of saves. Returns the
+        number of bytes written, or 0 if the state didn't fit */
+    uint32_t (*save_state_into)(JemuHandle, void* buffer, uint32_t size);
+
+    /** Restore a state written by save_state_into. Returns false if the
+        state was rejected, in which case the emulator may have been reset */
+    bool (*load_state_from)(JemuHandle, const void* buffer, uint32_t size);
+} JemuGameCoreState;
+
+typedef struct _JemuGameCoreIdle {
+    /** Run ahead through loops that only wait for an interrupt or a status
+        flag instead of emulating every pass. Output doesn't change, only
+        the time spent. Off by default. Call it from the thread that runs
+        the core's frames */
+    void (*set_idle_skip)(JemuHandle, bool enabled);
+} JemuGameCoreIdle;
+
+/** Version of JemuGameCoreCaps declared by this header */
+#define JEMU_GAME_CORE_CAPS_VERSION 1
+
+typedef enum {
+    /** Game core entry points call straight into the core, without runtime
+        type checks or further virtual dispatch, so they are cheap enough to
+        call per frame or per audio block */
+    JEMU_CAP_DIRECT_DISPATCH    = 1 << 0
+} JemuGameCoreCapFlags;
+
+typedef struct _JemuGameCoreCaps {
+    /** JEMU_GAME_CORE_CAPS_VERSION the plugin was built against. Hosts must
+        ignore fields newer than this version */
+    uint32_t version;
+
+    /** sizeof (JemuGameCoreCaps) as built into the plugin */
+    uint32_t size;
+
+    /** JemuGameCoreCapFlags */
+    uint32_t flags;
+} JemuGameCoreCaps;
+
 typedef struct _JemuGamePadSource {
     JemuGamePadSourceHandle handle;
     void (*connected)(JemuGamePadSourceHandle, JemuGamePadHandle);
@@ -178,6 +313,7 @@ typedef const JemuDescriptor* (*JemuDescriptorFunction)(const uint32_t);
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace jemu {
@@ -201,16 +337,40 @@ inline static DescriptorList& descriptors()
     return _descriptors;
 }
 
+/** Game core interface, bound at compile time.
+
+    Derive as `class MyCore : public GameCoreExtension<MyCore>` and hide the
+    defaults below with methods of the same name. Plugin<MyCore> calls them on
+    MyCore directly, so no virtual call or dynamic_cast is involved.
+*/
+template<class Derived>
 struct GameCoreExtension
 {
-    virtual void prepareGameCore() { }
-    virtual void releaseGameCoreResources() { }
-    virtual void buttonPress (const uint32_t button, const bool pressed) { }
-    virtual bool loadRom (const char* path) { return false; }
-    virtual void resetGameCore() { }
-    virtual void readAudio (float* output, int sampleCount) { }
-    virtual void tick() { }
-    virtual uint8_t* getVideoBuffer() const { return nullptr; }
+    void prepareGameCore() { }
+    void releaseGameCoreResources() { }
+    void buttonPress (const uint32_t button, const bool pressed) { }
+    bool loadRom (const char* path) { return false; }
+    void resetGameCore() { }
+    void readAudio (float* output, int sampleCount) { }
+    void tick() { }
+    uint8_t* getVideoBuffer() const { return nullptr; }
+    double getFrameRate() const { return 60.0; }
+    double getSampleRate() const { return 48000.0; }
+    void setOutputSampleRate (double) { }
+    bool setFrameBuffers (const JemuVideoFormat*, void* const*) { return false; }
+    int32_t acquireFrame() { return -1; }
+    uint32_t getStateSize() { return 0; }
+    uint32_t saveStateInto (void*, uint32_t) { return 0; }
+    bool loadStateFrom (const void*, uint32_t) { return false; }
+    void setIdleSkip (bool) { }
+
+    /** Cores should hide this to apply inputs and honor flags */
+    uint32_t runFrames (uint32_t count, const JemuInputFrame*, uint32_t)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            static_cast<Derived*> (this)->tick();
+        return count;
+    }
 };
 
 struct GamePadExtension
@@ -257,8 +417,18 @@ private:
         return _extensions;
     }
 
+    typedef std::is_base_of<GameCoreExtension<Instance>, Instance> IsGameCore;
+    typedef std::is_base_of<GamePadExtension, Instance> IsGamePad;
+
     /** default extension data getter */
     inline static const void* extensionData (const char* identifier) {
+        if (const void* data = gameCoreData (identifier, IsGameCore()))
+            return data;
+        return gamePadData (identifier, IsGamePad());
+    }
+
+    inline static const void* gameCoreData (const char*, std::false_type) { return nullptr; }
+    inline static const void* gameCoreData (const char* identifier, std::true_type) {
         void* data = nullptr;
 
         if (strcmp (identifier, JEMU_GAME_CORE) == 0)
@@ -276,7 +446,76 @@ private:
             _gamecore.video_frame   = &Impl::videoFrame;
             data = (void*) &_gamecore;
         }
-        else if (strcmp (identifier, JEMU_GAME_PAD) == 0)
+        else if (strcmp (identifier, JEMU_GAME_CORE_TIMING) == 0)
+        {
+            typedef PluginType::GameCoreImpl Impl;
+            static JemuGameCoreTiming _timing;
+            memset (&_timing, 0, sizeof (JemuGameCoreTiming));
+            _timing.frame_rate      = &Impl::frameRate;
+            _timing.sample_rate     = &Impl::sampleRate;
+            data = (void*) &_timing;
+        }
+        else if (strcmp (identifier, JEMU_GAME_CORE_AUDIO) == 0)
+        {
+            typedef PluginType::GameCoreImpl Impl;
+            static JemuGameCoreAudio _audio;
+            memset (&_audio, 0, sizeof (JemuGameCoreAudio));
+            _audio.set_output_rate  = &Impl::setOutputRate;
+            data = (void*) &_audio;
+        }
+        else if (strcmp (identifier, JEMU_GAME_CORE_VIDEO) == 0)
+        {
+            typedef PluginType::GameCoreImpl Impl;
+            static JemuGameCoreVideo _video;
+            memset (&_video, 0, sizeof (JemuGameCoreVideo));
+            _video.set_frame_buffers = &Impl::setFrameBuffers;
+            _video.acquire_frame     = &Impl::acquireFrame;
+            data = (void*) &_video;
+        }
+        else if (strcmp (identifier, JEMU_GAME_CORE_BATCH) == 0)
+        {
+            typedef PluginType::GameCoreImpl Impl;
+            static JemuGameCoreBatch _batch;
+            memset (&_batch, 0, sizeof (JemuGameCoreBatch));
+            _batch.run_frames = &Impl::runFrames;
+            data = (void*) &_batch;
+        }
+        else if (strcmp (identifier, JEMU_GAME_CORE_STATE) == 0)
+        {
+            typedef PluginType::GameCoreImpl Impl;
+            static JemuGameCoreState _state;
+            memset (&_state, 0, sizeof (JemuGameCoreState));
+            _state.state_size       = &Impl::stateSize;
+            _state.save_state_into  = &Impl::saveStateInto;
+            _state.load_state_from  = &Impl::loadStateFrom;
+            data = (void*) &_state;
+        }
+        else if (strcmp (identifier, JEMU_GAME_CORE_IDLE) == 0)
+        {
+            typedef PluginType::GameCoreImpl Impl;
+            static JemuGameCoreIdle _idle;
+            memset (&_idle, 0, sizeof (JemuGameCoreIdle));
+            _idle.set_idle_skip     = &Impl::setIdleSkip;
+            data = (void*) &_idle;
+        }
+        else if (strcmp (identifier, JEMU_GAME_CORE_CAPS) == 0)
+        {
+            static JemuGameCoreCaps _caps;
+            memset (&_caps, 0, sizeof (JemuGameCoreCaps));
+            _caps.version   = JEMU_GAME_CORE_CAPS_VERSION;
+            _caps.size      = sizeof (JemuGameCoreCaps);
+            _caps.flags     = JEMU_CAP_DIRECT_DISPATCH;
+            data = (void*) &_caps;
+        }
+
+        return data;
+    }
+
+    inline static const void* gamePadData (const char*, std::false_type) { return nullptr; }
+    inline static const void* gamePadData (const char* identifier, std::true_type) {
+        void* data = nullptr;
+
+        if (strcmp (identifier, JEMU_GAME_PAD) == 0)
         {
             typedef PluginType::GamePadImpl Impl;
             static JemuGamePad _gamepad;
@@ -304,56 +543,87 @@ private:
         return iter != extensions().end() ? (*iter).second : nullptr;
     }
 
+    /** Game core entry points. Handles are always instances made by
+        instantiate, so each call is a static_cast and a direct call into
+        Instance, which must derive from GameCoreExtension<Instance> */
     struct GameCoreImpl
     {
+        inline static Instance& core (JemuHandle handle) {
+            return *static_cast<Instance*> (handle);
+        }
+
         inline static void prepare (JemuHandle handle) {
-            if (auto* instance = static_cast<Instance*> (handle))
-                if (auto* core = dynamic_cast<GameCoreExtension*> (instance))
-                    core->prepareGameCore();
+            core (handle).prepareGameCore();
         }
 
         inline static void release (JemuHandle handle) {
-            if (auto* instance = static_cast<Instance*> (handle))
-                if (auto* core = dynamic_cast<GameCoreExtension*> (instance))
-                    core->releaseGameCoreResources();
+            core (handle).releaseGameCoreResources();
         }
 
         inline static void buttonPress (JemuHandle handle, const uint32_t button, const bool pressed) {
-            if (auto* instance = static_cast<Instance*> (handle))
-                if (auto* core = dynamic_cast<GameCoreExtension*> (instance))
-                    core->buttonPress (button, pressed);
+            core (handle).buttonPress (button, pressed);
         }
 
         inline static bool load (JemuHandle handle, const char* path) {
-            if (auto* instance = static_cast<Instance*> (handle))
-                if (auto* core = dynamic_cast<GameCoreExtension*> (instance))
-                    return core->loadRom (path);
-            return false;
+            return core (handle).loadRom (path);
         }
 
         inline static void readAudio (JemuHandle handle, float* output, uint32_t sampleCount) {
-            if (auto* instance = static_cast<Instance*> (handle))
-                if (auto* core = dynamic_cast<GameCoreExtension*> (instance))
-                    core->readAudio (output, static_cast<int> (sampleCount));
+            core (handle).readAudio (output, static_cast<int> (sampleCount));
         }
 
         inline static void reset (JemuHandle handle) {
-            if (auto* instance = static_cast<Instance*> (handle))
-                if (auto* core = dynamic_cast<GameCoreExtension*> (instance))
-                    core->resetGameCore();
+            core (handle).resetGameCore();
         }
 
         inline static void tick (JemuHandle handle) {
-            if (auto* instance = static_cast<Instance*> (handle))
-                if (auto* core = dynamic_cast<GameCoreExtension*> (instance))
-                    core->tick();
+            core (handle).tick();
         }
 
         inline static uint8_t* videoFrame (JemuHandle handle) {
-            if (auto* instance = static_cast<Instance*> (handle))
-                if (auto* core = dynamic_cast<GameCoreExtension*> (instance))
-                    return core->getVideoBuffer();
-            return nullptr;
+            return core (handle).getVideoBuffer();
+        }
+
+        inline static double frameRate (JemuHandle handle) {
+            return core (handle).getFrameRate();
+        }
+
+        inline static double sampleRate (JemuHandle handle) {
+            return core (handle).getSampleRate();
+        }
+
+        inline static void setOutputRate (JemuHandle handle, double rate) {
+            core (handle).setOutputSampleRate (rate);
+        }
+
+        inline static bool setFrameBuffers (JemuHandle handle, const JemuVideoFormat* format,
+                                            void* const* buffers) {
+            return core (handle).setFrameBuffers (format, buffers);
+        }
+
+        inline static int32_t acquireFrame (JemuHandle handle) {
+            return core (handle).acquireFrame();
+        }
+
+        inline static uint32_t runFrames (JemuHandle handle, uint32_t count,
+                                          const JemuInputFrame* inputs, uint32_t flags) {
+            return core (handle).runFrames (count, inputs, flags);
+        }
+
+        inline static uint32_t stateSize (JemuHandle handle) {
+            return core (handle).getStateSize();
+        }
+
+        inline static uint32_t saveStateInto (JemuHandle handle, void* buffer, uint32_t size) {
+            return core (handle).saveStateInto (buffer, size);
+        }
+
+        inline static bool loadStateFrom (JemuHandle handle, const void* buffer, uint32_t size) {
+            return core (handle).loadStateFrom (buffer, size);
+        }
+
+        inline static void setIdleSkip (JemuHandle handle, bool enabled) {
+            core (handle).setIdleSkip (enabled);
         }
     };
 
@@ -361,8 +631,7 @@ private:
     {
         inline static void discover (JemuHandle handle, bool scan) {
             if (auto *instance = static_cast<Instance*> (handle))
-                if (auto* pad = dynamic_cast<GamePadExtension*> (instance))
-                    pad->discoverGamePads (scan);
+                static_cast<GamePadExtension*> (instance)->discoverGamePads (scan);
         }
 
         inline static const char* name (JemuHandle handle, JemuGamePadHandle gamecore) {
@@ -373,7 +642,7 @@ private:
 
 }
 
-#define JEMU_REGISTER_PLUGIN(t, i, e) static uint32_t __t = jemu::Plugin<t>::registerDescriptor(i, e); \
+#define JEMU_REGISTER_PLUGIN(t, i, ...) static uint32_t __t = jemu::Plugin<t>::registerDescriptor(i, __VA_ARGS__); \
     JEMU_SYMBOL_EXPORT const JemuDescriptor* jemu_descriptor (const uint32_t index) { \
         return index < jemu::descriptors().size() \
             ? &jemu::descriptors()[index] : NULL; }
@@ -0,0 +1,111 @@
+/*
+    This file is part of Jemu
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include "jemu/ringbuffer.h"
+
+namespace jemu {
+
+/** Dynamic rate control for a mono 16-bit sample ring.
+
+    Emulated and device clocks never agree exactly, so a ring filled once per
+    frame and drained by the audio device slowly drifts until it underruns or
+    overflows. DynamicRateControl drains the ring through a linear resampler
+    whose ratio is nudged by at most maxDelta, consuming slightly faster when
+    the ring is more than half full and slightly slower when it is less. The
+    ring settles around half full and the pitch change stays inaudible.
+
+    The adjustment is applied on top of a nominal ratio, the ring's sample
+    rate over the rate the output is played at, so the ring only has to
+    absorb clock drift and not a sample rate mismatch.
+
+    Call process() from the ring's reader thread only.
+*/
+class DynamicRateControl
+{
+public:
+    explicit DynamicRateControl (double maximumDelta = 0.005)
+        : maxDelta (maximumDelta) { }
+
+    /** Set the nominal input/output sample rate ratio. Any thread */
+    inline void setNominalRatio (double ratio)
+    {
+        nominalRatio.store (ratio > 0.0 ? ratio : 1.0, std::memory_order_relaxed);
+    }
+
+    /** Forget the fractional read position, e.g. after the ring was reset */
+    inline void reset() { position = 0.0; }
+
+    /** Write numSamples floats to output, reading from ring. Returns false
+        and writes silence if the ring doesn't hold enough samples. */
+    bool process (RingBuffer& ring, float* output, int numSamples)
+    {
+        if (numSamples <= 0)
+            return true;
+
+        const uint32_t capacity = ring.capacity() / sizeof (int16_t);
+        const uint32_t available = ring.readSpace() / sizeof (int16_t);
+        const double fill = capacity > 0 ? (double) available / (double) capacity : 0.0;
+        const double ratio = nominalRatio.load (std::memory_order_relaxed)
+            * (1.0 + maxDelta * (2.0 * fill - 1.0));
+
+        // the last output sample interpolates between two input samples
+        const uint32_t needed = static_cast<uint32_t> (position + (numSamples - 1) * ratio) + 2;
+        const RingBuffer::Regions regions (ring.readRegions (needed * sizeof (int16_t)));
+        if (regions.total() != needed * sizeof (int16_t))
+        {
+            for (int i = 0; i < numSamples; ++i)
+                output[i] = 0.f;
+            return false;
+        }
+
+        const int16_t* const first  = reinterpret_cast<const int16_t*> (regions.data[0]);
+        const int16_t* const second = reinterpret_cast<const int16_t*> (regions.data[1]);
+        const uint32_t firstSize = regions.size[0] / sizeof (int16_t);
+        auto sampleAt = [=] (uint32_t index) -> float {
+            return index < firstSize ? first[index] : second[index - firstSize];
+        };
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double p = position + i * ratio;
+            const uint32_t index = static_cast<uint32_t> (p);
+            const float frac = static_cast<float> (p - index);
+            const float s0 = sampleAt (index);
+            const float s1 = sampleAt (index + 1);
+            output[i] = (s0 + (s1 - s0) * frac) * (1.f / 32768.f);
+        }
+
+        const double end = position + numSamples * ratio;
+        const uint32_t consumed = static_cast<uint32_t> (end);
+        position = end - consumed;
+        ring.commitRead (consumed * sizeof (int16_t));
+        return true;
+    }
+
+private:
+    const double maxDelta;
+    std::atomic<double> nominalRatio { 1.0 };
+    double position = 0.0;
+};
+
+}
@@ -28,11 +28,30 @@
 
 namespace jemu {
 
+/** Lock-free single-producer/single-consumer ring buffer.
+
+    Exactly one thread may write and exactly one thread may read.  The read
+    and write heads live on separate cache lines and are published with
+    acquire/release ordering, so neither side ever blocks the other.
+
+    Besides the copying read()/write() calls, the buffer hands out
+    Regions: the one or two contiguous spans that a read or write of a given
+    size covers.  Fill (or consume) them in place, then commit.
+*/
 class RingBuffer
 {
 public:
-    /** Create a new ring buffer */
+    /** Up to two contiguous spans inside the buffer.  The second span is
+        only used when the region wraps around the end of the buffer. */
+    struct Regions
+    {
+        char* data[2];
+        uint32_t size[2];
+
+        inline uint32_t total() const { return size[0] + size[1]; }
+    };
 
+    /** Create a new ring buffer */
     explicit RingBuffer (uint32_t capacity)
         : bufferSize (jemu::nextPowerOfTwo (capacity)),
           sizeMask (bufferSize - 1),
@@ -72,8 +91,8 @@ public:
       */
     inline void reset()
     {
-        writeHead = 0;
-        readHead  = 0;
+        writeHead.store (0, std::memory_order_relaxed);
+        readHead.store (0, std::memory_order_relaxed);
     }
 
     /** Clear the RingBuffer. Alias of RingBuffer::reset */
@@ -82,90 +101,128 @@ public:
     /** Return the number of bytes of space available for reading. */
     inline uint32_t readSpace() const
     {
-        return readSpaceInternal (readHead, writeHead);
+        return readSpaceInternal (readHead.load (std::memory_order_acquire),
+                                  writeHead.load (std::memory_order_acquire));
     }
 
     /** Return the number of bytes of space available for writing. */
     inline uint32_t writeSpace() const
     {
-        return writeSpaceInternal (readHead, writeHead);
+        return writeSpaceInternal (readHead.load (std::memory_order_acquire),
+                                   writeHead.load (std::memory_order_acquire));
     }
 
     /** Return the capacity (i.e. total write space when empty). */
     inline uint32_t capacity() const { return bufferSize - 1; }
 
+    /** Return the spans holding the next `size` readable bytes, or empty
+        regions if less than `size` bytes are available.  Reader only. */
+    inline Regions readRegions (uint32_t size) const
+    {
+        const uint32_t r = readHead.load (std::memory_order_relaxed);
+        const uint32_t w = writeHead.load (std::memory_order_acquire);
+        return readSpaceInternal (r, w) < size ? Regions() : regionsAt (r, size);
+    }
+
+    /** Release `size` bytes previously obtained from readRegions. */
+    inline void commitRead (uint32_t size)
+    {
+        const uint32_t r = readHead.load (std::memory_order_relaxed);
+        readHead.store ((r + size) & sizeMask, std::memory_order_release);
+    }
+
+    /** Return the spans for the next `size` writable bytes, or empty regions
+        if less than `size` bytes are free.  Writer only. */
+    inline Regions writeRegions (uint32_t size) const
+    {
+        const uint32_t r = readHead.load (std::memory_order_acquire);
+        const uint32_t w = writeHead.load (std::memory_order_relaxed);
+        return writeSpaceInternal (r, w) < size ? Regions() : regionsAt (w, size);
+    }
+
+    /** Publish `size` bytes previously filled through writeRegions. */
+    inline void commitWrite (uint32_t size)
+    {
+        const uint32_t w = writeHead.load (std::memory_order_relaxed);
+        writeHead.store ((w + size) & sizeMask, std::memory_order_release);
+    }
+
     /** Read from the RingBuffer without advancing the read head. */
-    inline uint32_t peek (uint32_t size, void* dst)
+    inline uint32_t peek (uint32_t size, void* dst) const
     {
-        return peekInternal (readHead, writeHead, size, dst);
+        const Regions regions (readRegions (size));
+        if (regions.total() != size || size == 0)
+            return 0;
+        memcpy (dst, regions.data[0], regions.size[0]);
+        if (regions.size[1] > 0)
+            memcpy ((char*) dst + regions.size[0], regions.data[1], regions.size[1]);
+        return size;
     }
 
     /** Read from the RingBuffer and advance the read head. */
     inline uint32_t read (uint32_t size, void* dst)
     {
-        const uint32_t r = readHead;
-        const uint32_t w = writeHead;
-
-        if (peekInternal (r, w, size, dst))
-        {
-            std::atomic_thread_fence (std::memory_order_acquire);
-            readHead = (r + size) & sizeMask;
-            return size;
-        }
-        else 
-        {
+        if (peek (size, dst) == 0)
             return 0;
-        }
+        commitRead (size);
+        return size;
     }
 
     /** Skip data in the RingBuffer (advance read head without reading). */
     inline uint32_t skip (uint32_t size)
     {
-        const uint32_t r = readHead;
-        const uint32_t w = writeHead;
-        if (readSpaceInternal (r, w) < size)
+        if (readSpace() < size)
             return 0;
-
-        std::atomic_thread_fence (std::memory_order_acquire);
-        readHead = (r + size) & sizeMask;
+        commitRead (size);
         return size;
     }
 
     /** Write data to the RingBuffer. */
     inline uint32_t write (uint32_t size, const void* src)
     {
-        const uint32_t r = readHead;
-        const uint32_t w = writeHead;
-        if (writeSpaceInternal (r, w) < size)
+        const Regions regions (writeRegions (size));
+        if (regions.total() != size || size == 0)
             return 0;
-
-        if (w + size <= bufferSize)
-        {
-            memcpy(&buffer[w], src, size);
-            std::atomic_thread_fence (std::memory_order_release);
-            writeHead = (w + size) & sizeMask;
-        }
-        else 
-        {
-            const uint32_t this_size = bufferSize - w;
-            assert (this_size < size);
-            assert (w + this_size <= bufferSize);
-            memcpy (&buffer[w], src, this_size);
-            memcpy (&buffer[0], (const char*)src + this_size, size - this_size);
-            std::atomic_thread_fence (std::memory_order_release);
-            writeHead = size - this_size;
-        }
-
+        memcpy (regions.data[0], src, regions.size[0]);
+        if (regions.size[1] > 0)
+            memcpy (regions.data[1], (const char*) src + regions.size[0], regions.size[1]);
+        commitWrite (size);
         return size;
     }
 
 private:
-    mutable uint32_t writeHead;
-    mutable uint32_t readHead;
+    // the writer owns writeHead and the reader owns readHead; pad them a
+    // cache line apart so the two threads don't false-share. Padding rather
+    // than alignas, since C++14 operator new ignores over-alignment
+    enum { cacheLineSize = 64 };
+    std::atomic<uint32_t> writeHead;
+    char writePadding [cacheLineSize - sizeof (std::atomic<uint32_t>)];
+    std::atomic<uint32_t> readHead;
+    char readPadding [cacheLineSize - sizeof (std::atomic<uint32_t>)];
     uint32_t bufferSize;
     uint32_t sizeMask;
     char* buffer;
 
+    inline Regions regionsAt (uint32_t head, uint32_t size) const
+    {
+        Regions regions;
+        if (head + size <= bufferSize)
+        {
+            regions.data[0] = &buffer[head];
+            regions.size[0] = size;
+            regions.data[1] = nullptr;
+            regions.size[1] = 0;
+        }
+        else
+        {
+            regions.data[0] = &buffer[head];
+            regions.size[0] = bufferSize - head;
+            regions.data[1] = &buffer[0];
+            regions.size[1] = size - regions.size[0];
+        }
+        return regions;
+    }
+
     inline uint32_t writeSpaceInternal (uint32_t r, uint32_t w) const
     {
         if (r == w) {
@@ -185,27 +242,6 @@ private:
             return (w - r + bufferSize) & sizeMask;
         }
     }
-
-    inline uint32_t peekInternal (uint32_t r, uint32_t w,
-                                   uint32_t size, void* dst) const
-    {
-        if (readSpaceInternal (r, w) < size) {
-            return 0;
-        }
-
-        if (r + size < bufferSize)
-        {
-            memcpy (dst, &buffer[r], size);
-        } 
-        else
-        {
-            const uint32_t first_size = bufferSize - r;
-            memcpy (dst, &buffer[r], first_size);
-            memcpy ((char*)dst + first_size, &buffer[0], size - first_size);
-        }
-
-        return size;
-    }
 };
 
 }
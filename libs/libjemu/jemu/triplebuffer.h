@@ -0,0 +1,80 @@
+/*
+    This file is part of Jemu
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+namespace jemu {
+
+/** Lock-free triple buffer handshake over three externally owned buffers.
+
+    Only indexes are exchanged. The producer renders into backIndex() and
+    calls publish(); the consumer calls acquire() to get the newest
+    published buffer, which the producer won't touch until the consumer
+    acquires again. Neither side ever waits. One producer thread and one
+    consumer thread.
+*/
+class TripleBuffer
+{
+public:
+    TripleBuffer() { reset(); }
+
+    /** Start over with no published buffer. Not thread-safe. */
+    inline void reset()
+    {
+        back = 0;
+        middle.store (1, std::memory_order_relaxed);
+        front = 2;
+        haveFront = false;
+    }
+
+    /** Index of the buffer the producer should render into. */
+    inline int backIndex() const { return back; }
+
+    /** Producer: hand the back buffer over as the newest complete frame. */
+    inline void publish()
+    {
+        back = middle.exchange (static_cast<uint8_t> (back | freshBit),
+                                std::memory_order_acq_rel) & indexMask;
+    }
+
+    /** Consumer: returns the newest published buffer index, or -1 if
+        nothing has been published yet. */
+    inline int acquire()
+    {
+        if ((middle.load (std::memory_order_relaxed) & freshBit) != 0)
+        {
+            front = middle.exchange (front, std::memory_order_acq_rel) & indexMask;
+            haveFront = true;
+        }
+
+        return haveFront ? front : -1;
+    }
+
+private:
+    enum : uint8_t { indexMask = 0x3, freshBit = 0x4 };
+
+    uint8_t back;                   // producer only
+    std::atomic<uint8_t> middle;    // index, plus freshBit when unread
+    uint8_t front;                  // consumer only
+    bool haveFront;
+};
+
+}
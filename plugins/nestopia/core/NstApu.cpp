@@ -815,7 +815,7 @@ namespace Nes
 			{
 				dword streamed = 0;
 
-				if (Sound::Output::lockCallback( *stream ))
+				if (stream->lockCallback( *stream ))
 				{
 					streamed = stream->length[0] + stream->length[1];
 
@@ -834,7 +834,7 @@ namespace Nes
 							FlushSound<byte,true>();
 					}
 
-					Sound::Output::unlockCallback( *stream );
+					stream->unlockCallback( *stream );
 				}
 
 				if (const dword rate = synchronizer.Clock( streamed, settings.rate, cpu ))
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NST_CALLBACKS_H
+#define NST_CALLBACKS_H
+
+#include "api/NstApiUser.hpp"
+#include "api/NstApiMachine.hpp"
+#include "api/NstApiCartridge.hpp"
+#include "api/NstApiFds.hpp"
+#include "api/NstApiNsf.hpp"
+#include "api/NstApiMovie.hpp"
+#include "api/NstApiRewinder.hpp"
+#include "api/NstApiTapeRecorder.hpp"
+#include "api/NstApiInput.hpp"
+
+#ifdef NST_PRAGMA_ONCE
+#pragma once
+#endif
+
+namespace Nes
+{
+	namespace Core
+	{
+		/*
+		* User callbacks of one emulator instance. Every Machine owns a set,
+		* which the Api interfaces bind to. Deep inside the core, where no
+		* Machine is at hand, Current() returns the set of the Machine this
+		* thread is currently running, as bound by a Scope around each
+		* Machine and Api entry point. Outside of any Scope it returns a set
+		* with nothing installed, so stray events are dropped rather than
+		* delivered to some other instance.
+		*/
+
+		class Callbacks
+		{
+		public:
+
+			Api::User::Callbacks user;
+			Api::Machine::Callbacks machine;
+			Api::Cartridge::Callbacks cartridge;
+			Api::Fds::Callbacks fds;
+			Api::Nsf::Callbacks nsf;
+			Api::Movie::Callbacks movie;
+			Api::Rewinder::Callbacks rewinder;
+			Api::TapeRecorder::Callbacks tapeRecorder;
+			Api::Input::Callbacks input;
+
+			class Scope
+			{
+				const Callbacks* const previous;
+
+			public:
+
+				explicit Scope(const Callbacks& callbacks)
+				: previous(current)
+				{
+					current = &callbacks;
+				}
+
+				~Scope()
+				{
+					current = previous;
+				}
+			};
+
+			static const Callbacks& Current()
+			{
+				return current ? *current : none;
+			}
+
+		private:
+
+			static thread_local const Callbacks* current;
+			static const Callbacks none;
+		};
+	}
+}
+
+#endif
@@ -32,8 +32,7 @@
 #include "NstChecksum.hpp"
 #include "NstCartridge.hpp"
 #include "NstCartridgeRomset.hpp"
-#include "api/NstApiCartridge.hpp"
-#include "api/NstApiUser.hpp"
+#include "NstCallbacks.hpp"
 
 namespace Nes
 {
@@ -713,7 +712,7 @@ namespace Nes
 						}
 					}
 
-					if (askProfile && Api::Cartridge::chooseProfileCallback)
+					if (askProfile && Callbacks::Current().cartridge.chooseProfileCallback)
 					{
 						std::vector<std::wstring> names( profiles.size() );
 
@@ -753,7 +752,7 @@ namespace Nes
 							);
 						}
 
-						const uint selected = Api::Cartridge::chooseProfileCallback( &profiles.front(), &names.front(), profiles.size() );
+						const uint selected = Callbacks::Current().cartridge.chooseProfileCallback( &profiles.front(), &names.front(), profiles.size() );
 
 						if (selected < profiles.size())
 							bestMatch = profiles.begin() + selected;
@@ -824,7 +823,7 @@ namespace Nes
 					if (readOnly)
 						continue;
 
-					if (!Api::User::fileIoCallback)
+					if (!Callbacks::Current().user.fileIoCallback)
 						throw RESULT_ERR_NOT_READY;
 
 					size = 0;
@@ -914,7 +913,7 @@ namespace Nes
 						};
 
 						Loader loader( it->file.c_str(), rom.Mem(size), it->size );
-						Api::User::fileIoCallback( loader );
+						Callbacks::Current().user.fileIoCallback( loader );
 
 						if (!loader.Loaded())
 							throw RESULT_ERR_INVALID_FILE;
@@ -26,13 +26,13 @@
 #include "NstCpu.hpp"
 #include "NstHook.hpp"
 #include "NstState.hpp"
-#include "api/NstApiUser.hpp"
+#include "NstCallbacks.hpp"
 
 namespace Nes
 {
 	namespace Core
 	{
-		dword Cpu::logged = 0;
+		#ifndef NST_THREADED_DISPATCH
 
 		void (Cpu::*const Cpu::opcodes[0x100])() =
 		{
@@ -102,6 +102,8 @@ namespace Nes
 			&Cpu::op0xFC, &Cpu::op0xFD, &Cpu::op0xFE, &Cpu::op0xFF
 		};
 
+		#endif
+
 		const byte Cpu::writeClocks[0x100] =
 		{
 			0x1C, 0x00, 0x00, 0xC0, 0x00, 0x00, 0x18, 0x18,
@@ -153,6 +155,7 @@ namespace Nes
 		apu   ( *this ),
 		map   ( this, &Cpu::Peek_Overflow, &Cpu::Poke_Overflow )
 		{
+			idle.enabled = false;
 			cycles.UpdateTable( GetModel() );
 			Reset( false, false );
 		}
@@ -197,6 +200,7 @@ namespace Nes
 			jammed  = false;
 			ticks   = 0;
 			logged  = 0;
+			code    = NULL;
 
 			pc = RESET_VECTOR;
 
@@ -207,7 +211,17 @@ namespace Nes
 
 			interrupt.Reset();
 			hooks.Clear();
+
+			idle.loop = Idle::NO_LOOP;
+			idle.clock = CYCLE_MAX;
+			idle.period = 0;
+			idle.polling = false;
+			idle.active = false;
+			idle.poll.Clear();
+
+			events.Clear();
 			linker.Clear();
+			map.Unbind();
 
 			if (on)
 			{
@@ -215,6 +229,7 @@ namespace Nes
 				map( 0x0800, 0x0FFF ).Set( &ram, &Cpu::Ram::Peek_Ram_1, &Cpu::Ram::Poke_Ram_1 );
 				map( 0x1000, 0x17FF ).Set( &ram, &Cpu::Ram::Peek_Ram_2, &Cpu::Ram::Poke_Ram_2 );
 				map( 0x1800, 0x1FFF ).Set( &ram, &Cpu::Ram::Peek_Ram_3, &Cpu::Ram::Poke_Ram_3 );
+				map( 0x0000, 0x1FFF ).Bind( ram.mem, RAM_SIZE );
 				map( 0x2000, 0xFFFF ).Set( this, &Cpu::Peek_Nop,        &Cpu::Poke_Nop        );
 				map( 0xFFFC         ).Set( this, &Cpu::Peek_Jam_1,      &Cpu::Poke_Nop        );
 				map( 0xFFFD         ).Set( this, &Cpu::Peek_Jam_2,      &Cpu::Poke_Nop        );
@@ -251,6 +266,28 @@ namespace Nes
 			}
 		}
 
+		void Cpu::EnableIdleSkip(bool enable)
+		{
+			idle.enabled = enable;
+		}
+
+		bool Cpu::IsIdleSkipEnabled() const
+		{
+			return idle.enabled;
+		}
+
+		void Cpu::SetIdlePort(const Address address,const Hook& hook)
+		{
+			// Lets idle loops poll the register at 'address' as long as
+			// it keeps its current peek handler. The hook is run before a
+			// skip and must report through HoldIdlePort() the last cycle
+			// up to which a read returns the same value as the last one.
+
+			idle.port = map[address];
+			idle.poll.Clear();
+			idle.poll.Add( hook );
+		}
+
 		void Cpu::AddHook(const Hook& hook)
 		{
 			hooks.Add( hook );
@@ -261,10 +298,26 @@ namespace Nes
 			hooks.Remove( hook );
 		}
 
+		void Cpu::AddEvent(const Hook& hook)
+		{
+			events.Add( hook );
+		}
+
+		void Cpu::RemoveEvent(const Hook& hook)
+		{
+			events.Remove( hook );
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("", on)
 		#endif
 
+		void Cpu::ScheduleEvent(const Hook& hook,const Cycle clock)
+		{
+			if (events.Schedule( hook, clock ))
+				cycles.NextRound( clock );
+		}
+
 		bool Cpu::IsOddCycle() const
 		{
 			return uint((ticks + cycles.count) % cycles.clock[1]);
@@ -486,7 +539,7 @@ namespace Nes
 			if (!(logged & which))
 			{
 				logged |= which;
-				Api::User::eventCallback( Api::User::EVENT_CPU_UNOFFICIAL_OPCODE, code );
+				Callbacks::Current().user.eventCallback( Api::User::EVENT_CPU_UNOFFICIAL_OPCODE, code );
 			}
 		}
 
@@ -555,10 +608,121 @@ namespace Nes
 			return hooks;
 		}
 
+		struct Cpu::Events::Event
+		{
+			Hook hook;
+			Cycle clock;
+		};
+
+		bool Cpu::Events::Schedule(const Hook& hook,const Cycle clock)
+		{
+			for (uint i=0, n=size; i < n; ++i)
+			{
+				if (events[i].hook == hook)
+				{
+					events[i].clock = clock;
+					Update();
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void Cpu::Events::Execute(const Cycle count)
+		{
+			for (uint i=0; i < size; ++i)
+			{
+				if (events[i].clock <= count)
+				{
+					events[i].clock = CYCLE_MAX;
+					events[i].hook.Execute();
+				}
+			}
+
+			Update();
+		}
+
+		void Cpu::Events::Update()
+		{
+			next = CYCLE_MAX;
+
+			for (uint i=0, n=size; i < n; ++i)
+			{
+				if (next > events[i].clock)
+					next = events[i].clock;
+			}
+		}
+
+		inline Cycle Cpu::Events::Next() const
+		{
+			return next;
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("s", on)
 		#endif
 
+		Cpu::Events::Events()
+		: events(new Event [MAX_EVENTS]), size(0), next(CYCLE_MAX) {}
+
+		Cpu::Events::~Events()
+		{
+			delete [] events;
+		}
+
+		void Cpu::Events::Clear()
+		{
+			size = 0;
+			next = CYCLE_MAX;
+		}
+
+		void Cpu::Events::Add(const Hook& hook)
+		{
+			for (uint i=0, n=size; i < n; ++i)
+			{
+				if (events[i].hook == hook)
+					return;
+			}
+
+			NST_VERIFY( size < MAX_EVENTS );
+
+			if (size < MAX_EVENTS)
+			{
+				events[size].hook = hook;
+				events[size].clock = CYCLE_MAX;
+				++size;
+			}
+		}
+
+		void Cpu::Events::Remove(const Hook& hook)
+		{
+			for (uint i=0, n=size; i < n; ++i)
+			{
+				if (events[i].hook == hook)
+				{
+					while (++i < n)
+						events[i-1] = events[i];
+
+					--size;
+					break;
+				}
+			}
+
+			Update();
+		}
+
+		void Cpu::Events::Rebase(const Cycle frame)
+		{
+			for (uint i=0, n=size; i < n; ++i)
+			{
+				if (events[i].clock != CYCLE_MAX)
+					events[i].clock = (events[i].clock > frame ? events[i].clock - frame : 0);
+			}
+
+			Update();
+		}
+
 		Cpu::Linker::Chain::Chain(const Port& p,uint a,uint l)
 		: Port(p), address(a), level(l) {}
 
@@ -743,19 +907,41 @@ namespace Nes
 		inline uint Cpu::IoMap::Peek8(const uint address) const
 		{
 			NST_ASSERT( address < FULL_SIZE );
-			return ports[address].Peek( address );
+
+			const Page& page = pages[address >> PAGE_SHIFT];
+
+			if (const byte* const* const mem = page.mem)
+				return (*mem)[address & page.memMask];
+			else
+				return page.ports[address & page.mask].Peek( address );
 		}
 
 		inline uint Cpu::IoMap::Peek16(const uint address) const
 		{
 			NST_ASSERT( address < FULL_SIZE-1 );
-			return ports[address].Peek( address ) | ports[address + 1].Peek( address + 1 ) << 8;
+			return Peek8( address ) | Peek8( address + 1 ) << 8;
 		}
 
 		inline void Cpu::IoMap::Poke8(const uint address,const uint data) const
 		{
 			NST_ASSERT( address < FULL_SIZE );
-			ports[address].Poke( address, data );
+
+			const Page& page = pages[address >> PAGE_SHIFT];
+			page.ports[address & page.mask].Poke( address, data );
+		}
+
+		inline const byte* Cpu::IoMap::Code(const uint address) const
+		{
+			NST_ASSERT( address < FULL_SIZE );
+
+			// Longest instruction must fit in the page
+
+			const Page& page = pages[address >> PAGE_SHIFT];
+
+			if (page.mem && (address & PAGE_MASK) <= PAGE_SIZE-3)
+				return *page.mem + (address & page.memMask);
+			else
+				return NULL;
 		}
 
 		#ifdef NST_MSVC_OPTIMIZE
@@ -830,20 +1016,52 @@ namespace Nes
 			return ram.mem[address & 0xFF] | uint(ram.mem[(address+1) & 0xFF]) << 8;
 		}
 
+		// The instruction's location is resolved once when the opcode is fetched.
+		// If it lies in plain memory its operands are then read straight from
+		// there instead of through the map. Operands are always fetched before
+		// the instruction touches the bus, so no bank can move under them.
+
+		inline uint Cpu::FetchOp()
+		{
+			code = map.Code( pc );
+			return FetchPc8();
+		}
+
 		inline uint Cpu::FetchPc8()
 		{
-			const uint data = map.Peek8( pc );
+			const uint data = code ? *code++ : map.Peek8( pc );
 			++pc;
 			return data;
 		}
 
 		inline uint Cpu::FetchPc16()
 		{
-			const uint data = map.Peek16( pc );
+			uint data;
+
+			if (code)
+			{
+				data = code[0] | uint(code[1]) << 8;
+				code += 2;
+			}
+			else
+			{
+				data = map.Peek16( pc );
+			}
+
 			pc += 2;
 			return data;
 		}
 
+		inline uint Cpu::PeekPc(const uint offset) const
+		{
+			return code ? code[offset] : map.Peek8( pc + offset );
+		}
+
+		inline uint Cpu::PeekPc16() const
+		{
+			return code ? code[0] | uint(code[1]) << 8 : map.Peek16( pc );
+		}
+
 		////////////////////////////////////////////////////////////////////////////////////////
 		// Immediate addressing
 		////////////////////////////////////////////////////////////////////////////////////////
@@ -960,9 +1178,8 @@ namespace Nes
 
 		uint Cpu::AbsReg_R(uint indexed)
 		{
-			uint data = pc;
-			indexed += map.Peek8( data );
-			data = (map.Peek8( data + 1 ) << 8) + indexed;
+			indexed += PeekPc( 0 );
+			uint data = (PeekPc( 1 ) << 8) + indexed;
 			cycles.count += cycles.clock[2];
 
 			if (indexed & 0x100)
@@ -980,9 +1197,8 @@ namespace Nes
 
 		uint Cpu::AbsReg_RW(uint& data,uint indexed)
 		{
-			uint address = pc;
-			indexed += map.Peek8( address );
-			address = (map.Peek8( address + 1 ) << 8) + indexed;
+			indexed += PeekPc( 0 );
+			uint address = (PeekPc( 1 ) << 8) + indexed;
 
 			map.Peek8( address - (indexed & 0x100) );
 			pc += 2;
@@ -999,9 +1215,8 @@ namespace Nes
 
 		NST_FORCE_INLINE uint Cpu::AbsReg_W(uint indexed)
 		{
-			uint address = pc;
-			indexed += map.Peek8( address );
-			address = (map.Peek8( address + 1 ) << 8) + indexed;
+			indexed += PeekPc( 0 );
+			uint address = (PeekPc( 1 ) << 8) + indexed;
 
 			map.Peek8( address - (indexed & 0x100) );
 			pc += 2;
@@ -1123,8 +1338,11 @@ namespace Nes
 		{
 			if ((!!tmp) == STATE)
 			{
-				pc = ((tmp=pc+1) + sign_extend_8(uint(map.Peek8( pc )))) & 0xFFFF;
+				pc = ((tmp=pc+1) + sign_extend_8(PeekPc( 0 ))) & 0xFFFF;
 				cycles.count += cycles.clock[2 + ((tmp^pc) >> 8 & 1)];
+
+				if (pc < tmp && idle.active)
+					SkipIdle( tmp-2 );
 			}
 			else
 			{
@@ -1248,15 +1466,20 @@ namespace Nes
 
 		NST_SINGLE_CALL void Cpu::JmpAbs()
 		{
-			pc = map.Peek16( pc );
+			const uint address = pc - 1;
+
+			pc = PeekPc16();
 			cycles.count += cycles.clock[JMP_ABS_CYCLES-1];
+
+			if (pc <= address && idle.active)
+				SkipIdle( address );
 		}
 
 		NST_SINGLE_CALL void Cpu::JmpInd()
 		{
 			// 6502 trap, can't cross between pages
 
-			const uint pos = map.Peek16( pc );
+			const uint pos = PeekPc16();
 			pc = map.Peek8( pos ) | (map.Peek8( (pos & 0xFF00) | ((pos + 1) & 0x00FF) ) << 8);
 
 			cycles.count += cycles.clock[JMP_IND_CYCLES-1];
@@ -1268,7 +1491,7 @@ namespace Nes
 			// one byte prior to the next instruction
 
 			Push16( pc + 1 );
-			pc = map.Peek16( pc );
+			pc = PeekPc16();
 			cycles.count += cycles.clock[JSR_CYCLES-1];
 		}
 
@@ -1795,7 +2018,7 @@ namespace Nes
 				jammed = true;
 				interrupt.Reset();
 				NST_DEBUG_MSG("6502 JAM");
-				Api::User::eventCallback( Api::User::EVENT_CPU_JAM );
+				Callbacks::Current().user.eventCallback( Api::User::EVENT_CPU_JAM );
 			}
 		}
 
@@ -1861,6 +2084,157 @@ namespace Nes
 			}
 		}
 
+		////////////////////////////////////////////////////////////////////////////////////////
+		// idle loops
+		////////////////////////////////////////////////////////////////////////////////////////
+
+		Cycle Cpu::GetIdlePeriod(const uint target,const uint end,ibool& polling) const
+		{
+			// Only loops that do nothing but read RAM or the idle port and
+			// compare qualify. Neither RAM nor the registers can change until
+			// the next interrupt, so every pass is the same as the one before
+			// for as long as the port holds its value.
+
+			polling = false;
+
+			if (target > end)
+				return 0;
+
+			uint address = target;
+			uint clocks = 0;
+
+			while (address != end)
+			{
+				const byte* const code = map.Code( address );
+
+				if (!code)
+					return 0;
+
+				switch (code[0])
+				{
+					case 0xA9: // LDA #
+					case 0xA2: // LDX #
+					case 0xA0: // LDY #
+					case 0xC9: // CMP #
+					case 0xE0: // CPX #
+					case 0xC0: // CPY #
+
+						clocks += 2;
+						address += 2;
+						break;
+
+					case 0xA5: // LDA zp
+					case 0xA6: // LDX zp
+					case 0xA4: // LDY zp
+					case 0xC5: // CMP zp
+					case 0xE4: // CPX zp
+					case 0xC4: // CPY zp
+					case 0x24: // BIT zp
+
+						clocks += 3;
+						address += 2;
+						break;
+
+					case 0xAD: // LDA abs
+					case 0xAE: // LDX abs
+					case 0xAC: // LDY abs
+					case 0xCD: // CMP abs
+					case 0xEC: // CPX abs
+					case 0xCC: // CPY abs
+					case 0x2C: // BIT abs
+
+						if ((code[1] | uint(code[2]) << 8) >= 0x2000)
+						{
+							if (!idle.poll.Size() || !map[code[1] | uint(code[2]) << 8].SamePeek( idle.port ))
+								return 0;
+
+							polling = true;
+						}
+
+						clocks += 4;
+						address += 3;
+						break;
+
+					case 0xEA: // NOP
+
+						clocks += 2;
+						address += 1;
+						break;
+
+					default:
+
+						return 0;
+				}
+
+				if (address > end)
+					return 0;
+			}
+
+			const byte* const code = map.Code( end );
+
+			if (!code)
+				return 0;
+
+			switch (code[0])
+			{
+				case 0x10: case 0x30: case 0x50: case 0x70:
+				case 0x90: case 0xB0: case 0xD0: case 0xF0:
+
+					clocks += 3 + (((end + 2) ^ target) >> 8 & 1);
+					break;
+
+				case 0x4C:
+
+					clocks += JMP_ABS_CYCLES;
+					break;
+
+				default:
+
+					return 0;
+			}
+
+			return clocks * cycles.clock[0];
+		}
+
+		void Cpu::SkipIdle(const uint loop)
+		{
+			// Called when a backward branch or jump at 'loop' was taken.
+			// A full pass at the expected rate since the last one confirms
+			// an idle loop, as an interrupt or DMA in between would have
+			// added to it. It is then run ahead in whole passes up to the
+			// last one before the next event or change of the idle port.
+
+			if (idle.loop != loop)
+			{
+				idle.loop = loop;
+				idle.period = GetIdlePeriod( pc, loop, idle.polling );
+			}
+			else if
+			(
+				idle.period &&
+				idle.clock != CYCLE_MAX &&
+				cycles.count - idle.clock == idle.period &&
+				cycles.round > cycles.count + idle.period &&
+				GetIdlePeriod( pc, loop, idle.polling ) == idle.period
+			)
+			{
+				Cycle end = cycles.round - 1;
+
+				if (idle.polling)
+				{
+					idle.poll.Ptr()->Execute();
+
+					if (end > idle.hold)
+						end = idle.hold;
+				}
+
+				if (end > cycles.count)
+					cycles.count += (end - cycles.count) / idle.period * idle.period;
+			}
+
+			idle.clock = cycles.count;
+		}
+
 		////////////////////////////////////////////////////////////////////////////////////////
 		// main
 		////////////////////////////////////////////////////////////////////////////////////////
@@ -1870,6 +2244,10 @@ namespace Nes
 			NST_VERIFY( cycles.count < cycles.frame );
 
 			apu.BeginFrame( sound );
+			map.Update();
+
+			idle.active = idle.enabled && !hooks.Size();
+			idle.clock = CYCLE_MAX;
 
 			Clock();
 
@@ -1888,6 +2266,9 @@ namespace Nes
 			for (const Hook *hook = hooks.Ptr(), *const end = hook+hooks.Size(); hook != end; ++hook)
 				hook->Execute();
 
+			if (cycles.count >= events.Next())
+				events.Execute( cycles.count );
+
 			NST_ASSERT( cycles.count >= cycles.frame && interrupt.nmiClock >= cycles.frame );
 
 			cycles.count -= cycles.frame;
@@ -1898,15 +2279,23 @@ namespace Nes
 
 			if (interrupt.irqClock != CYCLE_MAX)
 				interrupt.irqClock = (interrupt.irqClock > cycles.frame ? interrupt.irqClock - cycles.frame : 0);
+
+			events.Rebase( cycles.frame );
 		}
 
 		void Cpu::Clock()
 		{
+			if (cycles.count >= events.Next())
+				events.Execute( cycles.count );
+
 			Cycle clock = apu.Clock();
 
 			if (clock > cycles.frame)
 				clock = cycles.frame;
 
+			if (clock > events.Next())
+				clock = events.Next();
+
 			if (cycles.count < interrupt.nmiClock)
 			{
 				if (clock > interrupt.nmiClock)
@@ -1937,10 +2326,12 @@ namespace Nes
 			cycles.round = clock;
 		}
 
+		#ifndef NST_THREADED_DISPATCH
+
 		inline void Cpu::ExecuteOp()
 		{
 			cycles.offset = cycles.count;
-			(*this.*opcodes[opcode=FetchPc8()])();
+			(*this.*opcodes[opcode=FetchOp()])();
 		}
 
 		void Cpu::Run0()
@@ -2004,6 +2395,8 @@ namespace Nes
 			while (cycles.count < cycles.frame);
 		}
 
+		#endif
+
 		uint Cpu::Peek(const uint address) const
 		{
 			return map.Peek8( address );
@@ -2026,30 +2419,36 @@ namespace Nes
 		#define StoreIndX(a_,d_) StoreMem(a_,d_)
 		#define StoreIndY(a_,d_) StoreMem(a_,d_)
 
+		#ifdef NST_THREADED_DISPATCH
+		#define NES_OP(hex_) NST_SINGLE_CALL void Cpu::op##hex_()
+		#else
+		#define NES_OP(hex_) void Cpu::op##hex_()
+		#endif
+
 		#define NES_I____(instr_,hex_)                \
                                                       \
-		void Cpu::op##hex_()                          \
+		NES_OP(hex_)                                  \
 		{                                             \
 			instr_();                                 \
 		}
 
 		#define NES____C_(nop_,ticks_,hex_)           \
                                                       \
-		void Cpu::op##hex_()                          \
+		NES_OP(hex_)                                  \
 		{                                             \
 			cycles.count += cycles.clock[ticks_ - 1]; \
 		}
 
 		#define NES_IR___(instr_,addr_,hex_)          \
                                                       \
-		void Cpu::op##hex_()                          \
+		NES_OP(hex_)                                  \
 		{                                             \
 			instr_( addr_##_R() );                    \
 		}
 
 		#define NES_I_W__(instr_,addr_,hex_)          \
                                                       \
-		void Cpu::op##hex_()                          \
+		NES_OP(hex_)                                  \
 		{                                             \
 			const uint dst = addr_##_W();             \
 			Store##addr_( dst, instr_() );            \
@@ -2057,7 +2456,7 @@ namespace Nes
 
 		#define NES_IRW__(instr_,addr_,hex_)          \
                                                       \
-		void Cpu::op##hex_()                          \
+		NES_OP(hex_)                                  \
 		{                                             \
 			uint data;                                \
 			const uint dst = addr_##_RW( data );      \
@@ -2066,7 +2465,7 @@ namespace Nes
 
 		#define NES_IRA__(instr_,hex_)                \
                                                       \
-		void Cpu::op##hex_()                          \
+		NES_OP(hex_)                                  \
 		{                                             \
 			cycles.count += cycles.clock[1];          \
 			a = instr_( a );                          \
@@ -2074,7 +2473,7 @@ namespace Nes
 
 		#define NES_I_W_A(instr_,addr_,hex_)          \
                                                       \
-		void Cpu::op##hex_()                          \
+		NES_OP(hex_)                                  \
 		{                                             \
 			const uint dst = addr_##_W();             \
 			Store##addr_( dst, instr_(dst) );         \
@@ -2082,7 +2481,7 @@ namespace Nes
 
 		#define NES_IP_C_(instr_,ops_,ticks_,hex_)    \
                                                       \
-		void Cpu::op##hex_()                          \
+		NES_OP(hex_)                                  \
 		{                                             \
 			pc += ops_;                               \
 			cycles.count += cycles.clock[ticks_ - 1]; \
@@ -2373,6 +2772,7 @@ namespace Nes
 		#undef StoreIndX
 		#undef StoreIndY
 
+		#undef NES_OP
 		#undef NES_I____
 		#undef NES____C_
 		#undef NES_IR___
@@ -2381,5 +2781,230 @@ namespace Nes
 		#undef NES_IRA__
 		#undef NES_I_W_A
 		#undef NES_IP_C_
+
+		#ifdef NST_THREADED_DISPATCH
+
+		////////////////////////////////////////////////////////////////////////////////////////
+		// threaded dispatch
+		////////////////////////////////////////////////////////////////////////////////////////
+
+		struct Cpu::NoHooks
+		{
+			void Execute() const {}
+		};
+
+		struct Cpu::HookList
+		{
+			const Hook* first;
+			const Hook* last;
+
+			void Execute() const
+			{
+				const Hook* NST_RESTRICT hook = first;
+
+				hook->Execute();
+
+				do
+				{
+					(++hook)->Execute();
+				}
+				while (hook != last);
+			}
+		};
+
+		// Same loop as Run0-2 but every opcode is inlined into it and ends
+		// with its own jump to the next one, which the branch predictor can
+		// learn per opcode instead of sharing one indirect call site.
+
+		#define NES_THREAD(hex_)                       \
+                                                       \
+			L##hex_:                                   \
+                                                       \
+			op##hex_();                                \
+			hook.Execute();                            \
+                                                       \
+			if (cycles.count < cycles.round)           \
+			{                                          \
+				cycles.offset = cycles.count;          \
+				goto *labels[opcode=FetchOp()];        \
+			}                                          \
+                                                       \
+			goto clock;
+
+		template<typename T>
+		void Cpu::RunThreaded(const T hook)
+		{
+			static const void* const labels[0x100] =
+			{
+				&&L0x00, &&L0x01, &&L0x02, &&L0x03,
+				&&L0x04, &&L0x05, &&L0x06, &&L0x07,
+				&&L0x08, &&L0x09, &&L0x0A, &&L0x0B,
+				&&L0x0C, &&L0x0D, &&L0x0E, &&L0x0F,
+				&&L0x10, &&L0x11, &&L0x12, &&L0x13,
+				&&L0x14, &&L0x15, &&L0x16, &&L0x17,
+				&&L0x18, &&L0x19, &&L0x1A, &&L0x1B,
+				&&L0x1C, &&L0x1D, &&L0x1E, &&L0x1F,
+				&&L0x20, &&L0x21, &&L0x22, &&L0x23,
+				&&L0x24, &&L0x25, &&L0x26, &&L0x27,
+				&&L0x28, &&L0x29, &&L0x2A, &&L0x2B,
+				&&L0x2C, &&L0x2D, &&L0x2E, &&L0x2F,
+				&&L0x30, &&L0x31, &&L0x32, &&L0x33,
+				&&L0x34, &&L0x35, &&L0x36, &&L0x37,
+				&&L0x38, &&L0x39, &&L0x3A, &&L0x3B,
+				&&L0x3C, &&L0x3D, &&L0x3E, &&L0x3F,
+				&&L0x40, &&L0x41, &&L0x42, &&L0x43,
+				&&L0x44, &&L0x45, &&L0x46, &&L0x47,
+				&&L0x48, &&L0x49, &&L0x4A, &&L0x4B,
+				&&L0x4C, &&L0x4D, &&L0x4E, &&L0x4F,
+				&&L0x50, &&L0x51, &&L0x52, &&L0x53,
+				&&L0x54, &&L0x55, &&L0x56, &&L0x57,
+				&&L0x58, &&L0x59, &&L0x5A, &&L0x5B,
+				&&L0x5C, &&L0x5D, &&L0x5E, &&L0x5F,
+				&&L0x60, &&L0x61, &&L0x62, &&L0x63,
+				&&L0x64, &&L0x65, &&L0x66, &&L0x67,
+				&&L0x68, &&L0x69, &&L0x6A, &&L0x6B,
+				&&L0x6C, &&L0x6D, &&L0x6E, &&L0x6F,
+				&&L0x70, &&L0x71, &&L0x72, &&L0x73,
+				&&L0x74, &&L0x75, &&L0x76, &&L0x77,
+				&&L0x78, &&L0x79, &&L0x7A, &&L0x7B,
+				&&L0x7C, &&L0x7D, &&L0x7E, &&L0x7F,
+				&&L0x80, &&L0x81, &&L0x82, &&L0x83,
+				&&L0x84, &&L0x85, &&L0x86, &&L0x87,
+				&&L0x88, &&L0x89, &&L0x8A, &&L0x8B,
+				&&L0x8C, &&L0x8D, &&L0x8E, &&L0x8F,
+				&&L0x90, &&L0x91, &&L0x92, &&L0x93,
+				&&L0x94, &&L0x95, &&L0x96, &&L0x97,
+				&&L0x98, &&L0x99, &&L0x9A, &&L0x9B,
+				&&L0x9C, &&L0x9D, &&L0x9E, &&L0x9F,
+				&&L0xA0, &&L0xA1, &&L0xA2, &&L0xA3,
+				&&L0xA4, &&L0xA5, &&L0xA6, &&L0xA7,
+				&&L0xA8, &&L0xA9, &&L0xAA, &&L0xAB,
+				&&L0xAC, &&L0xAD, &&L0xAE, &&L0xAF,
+				&&L0xB0, &&L0xB1, &&L0xB2, &&L0xB3,
+				&&L0xB4, &&L0xB5, &&L0xB6, &&L0xB7,
+				&&L0xB8, &&L0xB9, &&L0xBA, &&L0xBB,
+				&&L0xBC, &&L0xBD, &&L0xBE, &&L0xBF,
+				&&L0xC0, &&L0xC1, &&L0xC2, &&L0xC3,
+				&&L0xC4, &&L0xC5, &&L0xC6, &&L0xC7,
+				&&L0xC8, &&L0xC9, &&L0xCA, &&L0xCB,
+				&&L0xCC, &&L0xCD, &&L0xCE, &&L0xCF,
+				&&L0xD0, &&L0xD1, &&L0xD2, &&L0xD3,
+				&&L0xD4, &&L0xD5, &&L0xD6, &&L0xD7,
+				&&L0xD8, &&L0xD9, &&L0xDA, &&L0xDB,
+				&&L0xDC, &&L0xDD, &&L0xDE, &&L0xDF,
+				&&L0xE0, &&L0xE1, &&L0xE2, &&L0xE3,
+				&&L0xE4, &&L0xE5, &&L0xE6, &&L0xE7,
+				&&L0xE8, &&L0xE9, &&L0xEA, &&L0xEB,
+				&&L0xEC, &&L0xED, &&L0xEE, &&L0xEF,
+				&&L0xF0, &&L0xF1, &&L0xF2, &&L0xF3,
+				&&L0xF4, &&L0xF5, &&L0xF6, &&L0xF7,
+				&&L0xF8, &&L0xF9, &&L0xFA, &&L0xFB,
+				&&L0xFC, &&L0xFD, &&L0xFE, &&L0xFF
+			};
+
+			goto dispatch;
+
+		clock:
+
+			Clock();
+
+			if (cycles.count >= cycles.frame)
+				return;
+
+		dispatch:
+
+			cycles.offset = cycles.count;
+			goto *labels[opcode=FetchOp()];
+
+			NES_THREAD( 0x00 ) NES_THREAD( 0x01 ) NES_THREAD( 0x02 ) NES_THREAD( 0x03 )
+			NES_THREAD( 0x04 ) NES_THREAD( 0x05 ) NES_THREAD( 0x06 ) NES_THREAD( 0x07 )
+			NES_THREAD( 0x08 ) NES_THREAD( 0x09 ) NES_THREAD( 0x0A ) NES_THREAD( 0x0B )
+			NES_THREAD( 0x0C ) NES_THREAD( 0x0D ) NES_THREAD( 0x0E ) NES_THREAD( 0x0F )
+			NES_THREAD( 0x10 ) NES_THREAD( 0x11 ) NES_THREAD( 0x12 ) NES_THREAD( 0x13 )
+			NES_THREAD( 0x14 ) NES_THREAD( 0x15 ) NES_THREAD( 0x16 ) NES_THREAD( 0x17 )
+			NES_THREAD( 0x18 ) NES_THREAD( 0x19 ) NES_THREAD( 0x1A ) NES_THREAD( 0x1B )
+			NES_THREAD( 0x1C ) NES_THREAD( 0x1D ) NES_THREAD( 0x1E ) NES_THREAD( 0x1F )
+			NES_THREAD( 0x20 ) NES_THREAD( 0x21 ) NES_THREAD( 0x22 ) NES_THREAD( 0x23 )
+			NES_THREAD( 0x24 ) NES_THREAD( 0x25 ) NES_THREAD( 0x26 ) NES_THREAD( 0x27 )
+			NES_THREAD( 0x28 ) NES_THREAD( 0x29 ) NES_THREAD( 0x2A ) NES_THREAD( 0x2B )
+			NES_THREAD( 0x2C ) NES_THREAD( 0x2D ) NES_THREAD( 0x2E ) NES_THREAD( 0x2F )
+			NES_THREAD( 0x30 ) NES_THREAD( 0x31 ) NES_THREAD( 0x32 ) NES_THREAD( 0x33 )
+			NES_THREAD( 0x34 ) NES_THREAD( 0x35 ) NES_THREAD( 0x36 ) NES_THREAD( 0x37 )
+			NES_THREAD( 0x38 ) NES_THREAD( 0x39 ) NES_THREAD( 0x3A ) NES_THREAD( 0x3B )
+			NES_THREAD( 0x3C ) NES_THREAD( 0x3D ) NES_THREAD( 0x3E ) NES_THREAD( 0x3F )
+			NES_THREAD( 0x40 ) NES_THREAD( 0x41 ) NES_THREAD( 0x42 ) NES_THREAD( 0x43 )
+			NES_THREAD( 0x44 ) NES_THREAD( 0x45 ) NES_THREAD( 0x46 ) NES_THREAD( 0x47 )
+			NES_THREAD( 0x48 ) NES_THREAD( 0x49 ) NES_THREAD( 0x4A ) NES_THREAD( 0x4B )
+			NES_THREAD( 0x4C ) NES_THREAD( 0x4D ) NES_THREAD( 0x4E ) NES_THREAD( 0x4F )
+			NES_THREAD( 0x50 ) NES_THREAD( 0x51 ) NES_THREAD( 0x52 ) NES_THREAD( 0x53 )
+			NES_THREAD( 0x54 ) NES_THREAD( 0x55 ) NES_THREAD( 0x56 ) NES_THREAD( 0x57 )
+			NES_THREAD( 0x58 ) NES_THREAD( 0x59 ) NES_THREAD( 0x5A ) NES_THREAD( 0x5B )
+			NES_THREAD( 0x5C ) NES_THREAD( 0x5D ) NES_THREAD( 0x5E ) NES_THREAD( 0x5F )
+			NES_THREAD( 0x60 ) NES_THREAD( 0x61 ) NES_THREAD( 0x62 ) NES_THREAD( 0x63 )
+			NES_THREAD( 0x64 ) NES_THREAD( 0x65 ) NES_THREAD( 0x66 ) NES_THREAD( 0x67 )
+			NES_THREAD( 0x68 ) NES_THREAD( 0x69 ) NES_THREAD( 0x6A ) NES_THREAD( 0x6B )
+			NES_THREAD( 0x6C ) NES_THREAD( 0x6D ) NES_THREAD( 0x6E ) NES_THREAD( 0x6F )
+			NES_THREAD( 0x70 ) NES_THREAD( 0x71 ) NES_THREAD( 0x72 ) NES_THREAD( 0x73 )
+			NES_THREAD( 0x74 ) NES_THREAD( 0x75 ) NES_THREAD( 0x76 ) NES_THREAD( 0x77 )
+			NES_THREAD( 0x78 ) NES_THREAD( 0x79 ) NES_THREAD( 0x7A ) NES_THREAD( 0x7B )
+			NES_THREAD( 0x7C ) NES_THREAD( 0x7D ) NES_THREAD( 0x7E ) NES_THREAD( 0x7F )
+			NES_THREAD( 0x80 ) NES_THREAD( 0x81 ) NES_THREAD( 0x82 ) NES_THREAD( 0x83 )
+			NES_THREAD( 0x84 ) NES_THREAD( 0x85 ) NES_THREAD( 0x86 ) NES_THREAD( 0x87 )
+			NES_THREAD( 0x88 ) NES_THREAD( 0x89 ) NES_THREAD( 0x8A ) NES_THREAD( 0x8B )
+			NES_THREAD( 0x8C ) NES_THREAD( 0x8D ) NES_THREAD( 0x8E ) NES_THREAD( 0x8F )
+			NES_THREAD( 0x90 ) NES_THREAD( 0x91 ) NES_THREAD( 0x92 ) NES_THREAD( 0x93 )
+			NES_THREAD( 0x94 ) NES_THREAD( 0x95 ) NES_THREAD( 0x96 ) NES_THREAD( 0x97 )
+			NES_THREAD( 0x98 ) NES_THREAD( 0x99 ) NES_THREAD( 0x9A ) NES_THREAD( 0x9B )
+			NES_THREAD( 0x9C ) NES_THREAD( 0x9D ) NES_THREAD( 0x9E ) NES_THREAD( 0x9F )
+			NES_THREAD( 0xA0 ) NES_THREAD( 0xA1 ) NES_THREAD( 0xA2 ) NES_THREAD( 0xA3 )
+			NES_THREAD( 0xA4 ) NES_THREAD( 0xA5 ) NES_THREAD( 0xA6 ) NES_THREAD( 0xA7 )
+			NES_THREAD( 0xA8 ) NES_THREAD( 0xA9 ) NES_THREAD( 0xAA ) NES_THREAD( 0xAB )
+			NES_THREAD( 0xAC ) NES_THREAD( 0xAD ) NES_THREAD( 0xAE ) NES_THREAD( 0xAF )
+			NES_THREAD( 0xB0 ) NES_THREAD( 0xB1 ) NES_THREAD( 0xB2 ) NES_THREAD( 0xB3 )
+			NES_THREAD( 0xB4 ) NES_THREAD( 0xB5 ) NES_THREAD( 0xB6 ) NES_THREAD( 0xB7 )
+			NES_THREAD( 0xB8 ) NES_THREAD( 0xB9 ) NES_THREAD( 0xBA ) NES_THREAD( 0xBB )
+			NES_THREAD( 0xBC ) NES_THREAD( 0xBD ) NES_THREAD( 0xBE ) NES_THREAD( 0xBF )
+			NES_THREAD( 0xC0 ) NES_THREAD( 0xC1 ) NES_THREAD( 0xC2 ) NES_THREAD( 0xC3 )
+			NES_THREAD( 0xC4 ) NES_THREAD( 0xC5 ) NES_THREAD( 0xC6 ) NES_THREAD( 0xC7 )
+			NES_THREAD( 0xC8 ) NES_THREAD( 0xC9 ) NES_THREAD( 0xCA ) NES_THREAD( 0xCB )
+			NES_THREAD( 0xCC ) NES_THREAD( 0xCD ) NES_THREAD( 0xCE ) NES_THREAD( 0xCF )
+			NES_THREAD( 0xD0 ) NES_THREAD( 0xD1 ) NES_THREAD( 0xD2 ) NES_THREAD( 0xD3 )
+			NES_THREAD( 0xD4 ) NES_THREAD( 0xD5 ) NES_THREAD( 0xD6 ) NES_THREAD( 0xD7 )
+			NES_THREAD( 0xD8 ) NES_THREAD( 0xD9 ) NES_THREAD( 0xDA ) NES_THREAD( 0xDB )
+			NES_THREAD( 0xDC ) NES_THREAD( 0xDD ) NES_THREAD( 0xDE ) NES_THREAD( 0xDF )
+			NES_THREAD( 0xE0 ) NES_THREAD( 0xE1 ) NES_THREAD( 0xE2 ) NES_THREAD( 0xE3 )
+			NES_THREAD( 0xE4 ) NES_THREAD( 0xE5 ) NES_THREAD( 0xE6 ) NES_THREAD( 0xE7 )
+			NES_THREAD( 0xE8 ) NES_THREAD( 0xE9 ) NES_THREAD( 0xEA ) NES_THREAD( 0xEB )
+			NES_THREAD( 0xEC ) NES_THREAD( 0xED ) NES_THREAD( 0xEE ) NES_THREAD( 0xEF )
+			NES_THREAD( 0xF0 ) NES_THREAD( 0xF1 ) NES_THREAD( 0xF2 ) NES_THREAD( 0xF3 )
+			NES_THREAD( 0xF4 ) NES_THREAD( 0xF5 ) NES_THREAD( 0xF6 ) NES_THREAD( 0xF7 )
+			NES_THREAD( 0xF8 ) NES_THREAD( 0xF9 ) NES_THREAD( 0xFA ) NES_THREAD( 0xFB )
+			NES_THREAD( 0xFC ) NES_THREAD( 0xFD ) NES_THREAD( 0xFE ) NES_THREAD( 0xFF )
+		}
+
+		#undef NES_THREAD
+
+		void Cpu::Run0()
+		{
+			RunThreaded( NoHooks() );
+		}
+
+		void Cpu::Run1()
+		{
+			RunThreaded( *hooks.Ptr() );
+		}
+
+		void Cpu::Run2()
+		{
+			const HookList list =
+			{
+				hooks.Ptr(),
+				hooks.Ptr() + (hooks.Size() - 1)
+			};
+
+			RunThreaded( list );
+		}
+
+		#endif
 	}
 }
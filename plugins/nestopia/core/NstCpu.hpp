@@ -33,6 +33,10 @@
 #pragma once
 #endif
 
+#if NST_GCC >= 300 && !defined(NST_NO_THREADED_DISPATCH)
+#define NST_THREADED_DISPATCH
+#endif
+
 namespace Nes
 {
 	namespace Core
@@ -86,15 +90,21 @@ namespace Nes
 			dword GetFps() const;
 
 			void SetModel(CpuModel);
+			void EnableIdleSkip(bool);
+			bool IsIdleSkipEnabled() const;
+			void SetIdlePort(Address,const Hook&);
 			void AddHook(const Hook&);
 			void RemoveHook(const Hook&);
+			void AddEvent(const Hook&);
+			void RemoveEvent(const Hook&);
+			void ScheduleEvent(const Hook&,Cycle);
 
 			void SaveState(State::Saver&,dword,dword) const;
 			void LoadState(State::Loader&,dword,dword,dword);
 
 		private:
 
-			static void NotifyOp(const char (&)[4],dword);
+			void NotifyOp(const char (&)[4],dword);
 
 			enum
 			{
@@ -128,13 +138,32 @@ namespace Nes
 			uint FetchIRQISRVector();
 			void Clock();
 
+			NST_NO_INLINE void SkipIdle(uint);
+			Cycle GetIdlePeriod(uint,uint,ibool&) const;
+
 			void Run0();
 			void Run1();
 			void Run2();
 
+		#ifdef NST_THREADED_DISPATCH
+
+			struct NoHooks;
+			struct HookList;
+
+			template<typename T>
+			void RunThreaded(const T);
+
+		#else
+
 			inline void ExecuteOp();
+
+		#endif
+
+			inline uint FetchOp();
 			inline uint FetchPc8();
 			inline uint FetchPc16();
+			inline uint PeekPc(uint) const;
+			inline uint PeekPc16() const;
 			inline uint FetchZpg16(uint) const;
 
 			inline void Push8(uint);
@@ -416,6 +445,56 @@ namespace Nes
 				word capacity;
 			};
 
+			class Events
+			{
+			public:
+
+				Events();
+				~Events();
+
+				void Add(const Hook&);
+				void Remove(const Hook&);
+				bool Schedule(const Hook&,Cycle);
+				void Execute(Cycle);
+				void Rebase(Cycle);
+
+				void Clear();
+				inline Cycle Next() const;
+
+			private:
+
+				void Update();
+
+				enum
+				{
+					MAX_EVENTS = 4
+				};
+
+				struct Event;
+
+				Event* const events;
+				uint size;
+				Cycle next;
+			};
+
+			struct Idle
+			{
+				enum
+				{
+					NO_LOOP = 0x10000
+				};
+
+				uint loop;
+				Cycle clock;
+				Cycle period;
+				Cycle hold;
+				ibool polling;
+				ibool enabled;
+				ibool active;
+				Io::Port port;
+				Hooks poll;
+			};
+
 			struct Ram
 			{
 				typedef byte (&Ref)[RAM_SIZE];
@@ -443,6 +522,7 @@ namespace Nes
 				inline uint Peek8(uint) const;
 				inline uint Peek16(uint) const;
 				inline void Poke8(uint,uint) const;
+				inline const byte* Code(uint) const;
 			};
 
 			class Linker
@@ -476,7 +556,9 @@ namespace Nes
 			uint sp;
 			Flags flags;
 			Interrupt interrupt;
+			Idle idle;
 			Hooks hooks;
+			Events events;
 			uint opcode;
 			word jammed;
 			word model;
@@ -485,9 +567,12 @@ namespace Nes
 			Ram ram;
 			Apu apu;
 			IoMap map;
+			const byte* code;
+			dword logged;
 
-			static dword logged;
+		#ifndef NST_THREADED_DISPATCH
 			static void (Cpu::*const opcodes[0x100])();
+		#endif
 			static const byte writeClocks[0x100];
 
 		public:
@@ -503,6 +588,11 @@ namespace Nes
 				return cycles.count;
 			}
 
+			void HoldIdlePort(Cycle clock)
+			{
+				idle.hold = clock;
+			}
+
 			void DoIRQ(IrqLine line=IRQ_EXT)
 			{
 				DoIRQ( line, cycles.count );
@@ -28,6 +28,7 @@
 #include "NstCrc32.hpp"
 #include "NstState.hpp"
 #include "NstFds.hpp"
+#include "NstCallbacks.hpp"
 #include "api/NstApiInput.hpp"
 
 namespace Nes
@@ -58,93 +59,56 @@ namespace Nes
 		#pragma optimize("s", on)
 		#endif
 
-		class Fds::Bios
+		Fds::Bios::Bios()
+		: available(false)
 		{
-		public:
-
-			NES_DECL_PEEK( Rom );
-			NES_DECL_POKE( Nop );
-
-		private:
-
-			enum
-			{
-				FAMICOM_ID    = 0x5E607DCF,
-				TWINSYSTEM_ID = 0x4DF24A6C
-			};
-
-			byte rom[SIZE_8K];
-			bool available;
-
-		public:
+		}
 
-			Bios()
-			: available(false)
-			{
-			}
+		void Fds::Bios::Set(std::istream* const stdStream)
+		{
+			available = false;
 
-			void Set(std::istream* const stdStream)
+			if (stdStream)
 			{
-				available = false;
+				Stream::In(stdStream).Read( rom, SIZE_8K );
+				available = true;
 
-				if (stdStream)
+				if (Log::Available())
 				{
-					Stream::In(stdStream).Read( rom, SIZE_8K );
-					available = true;
-
-					if (Log::Available())
+					switch (Crc32::Compute( rom, SIZE_8K ))
 					{
-						switch (Crc32::Compute( rom, SIZE_8K ))
-						{
-							case FAMICOM_ID:
-							case TWINSYSTEM_ID:
+						case FAMICOM_ID:
+						case TWINSYSTEM_ID:
 
-								Log::Flush( "Fds: BIOS ROM ok" NST_LINEBREAK );
-								break;
+							Log::Flush( "Fds: BIOS ROM ok" NST_LINEBREAK );
+							break;
 
-							default:
+						default:
 
-								Log::Flush( "Fds: warning, unknown BIOS ROM!" NST_LINEBREAK );
-								break;
-						}
+							Log::Flush( "Fds: warning, unknown BIOS ROM!" NST_LINEBREAK );
+							break;
 					}
 				}
 			}
+		}
 
-			Result Get(std::ostream& stream) const
+		Result Fds::Bios::Get(std::ostream& stream) const
+		{
+			if (available)
 			{
-				if (available)
-				{
-					Stream::Out(&stream).Write( rom, SIZE_8K );
-					return RESULT_OK;
-				}
-				else
-				{
-					return RESULT_ERR_NOT_READY;
-				}
+				Stream::Out(&stream).Write( rom, SIZE_8K );
+				return RESULT_OK;
 			}
-
-			bool Available() const
+			else
 			{
-				return available;
+				return RESULT_ERR_NOT_READY;
 			}
-		};
+		}
 
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("", on)
 		#endif
 
-		Fds::Bios Fds::bios;
-
-		NES_PEEK_A(Fds::Bios,Rom)
-		{
-			return rom[address - 0xE000];
-		}
-
-		NES_POKE(Fds::Bios,Nop)
-		{
-		}
-
 		inline byte* Fds::Disks::Sides::operator [] (uint i) const
 		{
 			NST_ASSERT( i < count );
@@ -167,9 +131,10 @@ namespace Nes
 		adapter (context.cpu,disks.sides),
 		cpu     (context.cpu),
 		ppu     (context.ppu),
-		sound   (context.apu)
+		sound   (context.apu),
+		bios    (context.fdsBios)
 		{
-			if (!bios.Available())
+			if (!bios)
 				throw RESULT_ERR_MISSING_BIOS;
 
 			if (context.patch && context.patchResult)
@@ -224,7 +189,7 @@ namespace Nes
 			cpu.Map( 0x4092         ).Set( this, &Fds::Peek_4092, &Fds::Poke_Nop  );
 
 			cpu.Map( 0x6000, 0xDFFF ).Set( &ram, &Fds::Ram::Peek_Ram, &Fds::Ram::Poke_Ram );
-			cpu.Map( 0xE000, 0xFFFF ).Set( &bios, &Bios::Peek_Rom, &Bios::Poke_Nop );
+			cpu.Map( 0xE000, 0xFFFF ).Set( this, &Fds::Peek_Bios, &Fds::Poke_Nop );
 		}
 
 		bool Fds::PowerOff()
@@ -232,27 +197,12 @@ namespace Nes
 			if (io.led != Api::Fds::MOTOR_OFF)
 			{
 				io.led = Api::Fds::MOTOR_OFF;
-				Api::Fds::driveCallback( Api::Fds::MOTOR_OFF );
+				Callbacks::Current().fds.driveCallback( Api::Fds::MOTOR_OFF );
 			}
 
 			return true;
 		}
 
-		void Fds::SetBios(std::istream* stream)
-		{
-			bios.Set( stream );
-		}
-
-		Result Fds::GetBios(std::ostream& stream)
-		{
-			return bios.Get( stream );
-		}
-
-		bool Fds::HasBios()
-		{
-			return bios.Available();
-		}
-
 		Region Fds::GetDesiredRegion() const
 		{
 			return REGION_NTSC;
@@ -309,9 +259,9 @@ namespace Nes
 						adapter.Mount( NULL );
 
 						if (prev != Disks::EJECTED)
-							Api::Fds::diskCallback( Api::Fds::DISK_EJECT, prev / 2, prev % 2 );
+							Callbacks::Current().fds.diskCallback( Api::Fds::DISK_EJECT, prev / 2, prev % 2 );
 
-						Api::Fds::diskCallback( Api::Fds::DISK_INSERT, disk / 2, disk % 2 );
+						Callbacks::Current().fds.diskCallback( Api::Fds::DISK_INSERT, disk / 2, disk % 2 );
 
 						return RESULT_OK;
 					}
@@ -334,7 +284,7 @@ namespace Nes
 
 				adapter.Mount( NULL );
 
-				Api::Fds::diskCallback( Api::Fds::DISK_EJECT, prev / 2, prev % 2 );
+				Callbacks::Current().fds.diskCallback( Api::Fds::DISK_EJECT, prev / 2, prev % 2 );
 
 				return RESULT_OK;
 			}
@@ -537,6 +487,11 @@ namespace Nes
 		{
 		}
 
+		NES_PEEK_A(Fds,Bios)
+		{
+			return bios[address - 0xE000];
+		}
+
 		NES_POKE_D(Fds,4023)
 		{
 			io.ctrl = data;
@@ -1416,7 +1371,7 @@ namespace Nes
 				if (io.led != led && (io.led != Api::Fds::MOTOR_WRITE || led != Api::Fds::MOTOR_READ))
 				{
 					io.led = led;
-					Api::Fds::driveCallback( static_cast<Api::Fds::Motor>(io.led) );
+					Callbacks::Current().fds.driveCallback( static_cast<Api::Fds::Motor>(io.led) );
 				}
 			}
 			else if (!--disks.mounting)
@@ -1477,7 +1432,7 @@ namespace Nes
 			{
 				disks.writeProtected = true;
 				adapter.WriteProtect();
-				Api::Fds::diskCallback( Api::Fds::DISK_NONSTANDARD, disks.current / 2, disks.current % 2 );
+				Callbacks::Current().fds.diskCallback( Api::Fds::DISK_NONSTANDARD, disks.current / 2, disks.current % 2 );
 			}
 
 			return data & 0xFF;
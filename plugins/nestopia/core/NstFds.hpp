@@ -51,9 +51,38 @@ namespace Nes
 			Result EjectDisk();
 			Result GetDiskData(uint,Api::Fds::DiskData&) const;
 
-			static void SetBios(std::istream*);
-			static Result GetBios(std::ostream&);
-			static bool HasBios();
+			class Bios
+			{
+			public:
+
+				Bios();
+
+				void Set(std::istream*);
+				Result Get(std::ostream&) const;
+
+			private:
+
+				enum
+				{
+					FAMICOM_ID    = 0x5E607DCF,
+					TWINSYSTEM_ID = 0x4DF24A6C
+				};
+
+				byte rom[SIZE_8K];
+				bool available;
+
+			public:
+
+				bool Available() const
+				{
+					return available;
+				}
+
+				const byte* Rom() const
+				{
+					return available ? rom : NULL;
+				}
+			};
 
 			class Sound : public Apu::Channel
 			{
@@ -235,6 +264,7 @@ namespace Nes
 
 			NES_DECL_PEEK( Nop  );
 			NES_DECL_POKE( Nop  );
+			NES_DECL_PEEK( Bios );
 			NES_DECL_POKE( 4023 );
 			NES_DECL_POKE( 4025 );
 			NES_DECL_POKE( 4026 );
@@ -474,9 +504,7 @@ namespace Nes
 			Ram ram;
 			Sound sound;
 			mutable Checksum checksum;
-
-			class Bios;
-			static Bios bios;
+			const byte* const bios;
 
 		public:
 
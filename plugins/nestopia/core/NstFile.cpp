@@ -29,7 +29,7 @@
 #include "NstChecksum.hpp"
 #include "NstPatcher.hpp"
 #include "NstFile.hpp"
-#include "api/NstApiUser.hpp"
+#include "NstCallbacks.hpp"
 
 namespace Nes
 {
@@ -239,7 +239,7 @@ namespace Nes
 
 			{
 				Loader loader( type, loadBlock, loadBlockCount, altered );
-				Api::User::fileIoCallback( loader );
+				Callbacks::Current().user.fileIoCallback( loader );
 			}
 
 			context.checksum.Clear();
@@ -349,7 +349,7 @@ namespace Nes
 
 			{
 				Loader loader( type, buffer, maxsize );
-				Api::User::fileIoCallback( loader );
+				Callbacks::Current().user.fileIoCallback( loader );
 			}
 
 			if (buffer.Size())
@@ -514,7 +514,7 @@ namespace Nes
 				};
 
 				Saver saver( type, saveBlock, saveBlockCount, context.data );
-				Api::User::fileIoCallback( saver );
+				Callbacks::Current().user.fileIoCallback( saver );
 			}
 		}
 
@@ -79,10 +79,11 @@ namespace Nes
 				const FavoredSystem favoredSystem;
 				const bool askProfile;
 				const ImageDatabase* const database;
+				const byte* const fdsBios;
 				Result result;
 
-				Context(Type t,Cpu& c,Apu& a,Ppu& p,std::istream& s,std::istream* h,bool k,Result* r,FavoredSystem f,bool b,const ImageDatabase* d)
-				: type(t), cpu(c), apu(a), ppu(p), stream(s), patch(h), patchBypassChecksum(k), patchResult(r), favoredSystem(f), askProfile(b), database(d), result(RESULT_OK) {}
+				Context(Type t,Cpu& c,Apu& a,Ppu& p,std::istream& s,std::istream* h,bool k,Result* r,FavoredSystem f,bool b,const ImageDatabase* d,const byte* i)
+				: type(t), cpu(c), apu(a), ppu(p), stream(s), patch(h), patchBypassChecksum(k), patchResult(r), favoredSystem(f), askProfile(b), database(d), fdsBios(i), result(RESULT_OK) {}
 			};
 
 			static Image* Load(Context&);
@@ -37,6 +37,15 @@ namespace Nes
 	{
 		namespace Io
 		{
+			/*
+			* Address space split into 256 byte pages. A page stores only as many
+			* ports as it takes for them to repeat, so a page with one handler
+			* holds a single port and the PPU's eight registers mirrored across
+			* $2000-$3FFF hold eight per page. Pages may also be bound to memory,
+			* in which case reads are plain loads for as long as the page's ports
+			* still read through the handler they were bound with.
+			*/
+
 			template<dword N> class Map
 			{
 			public:
@@ -45,79 +54,339 @@ namespace Nes
 				{
 					SIZE = N,
 					OVERFLOW_SIZE = 0x100,
-					FULL_SIZE = SIZE + OVERFLOW_SIZE
+					FULL_SIZE = SIZE + OVERFLOW_SIZE,
+					PAGE_SHIFT = 8,
+					PAGE_SIZE = 1U << PAGE_SHIFT,
+					PAGE_MASK = PAGE_SIZE - 1,
+					NUM_PAGES = FULL_SIZE / PAGE_SIZE
 				};
 
+			private:
+
+				NST_COMPILE_ASSERT( SIZE % PAGE_SIZE == 0 && OVERFLOW_SIZE == PAGE_SIZE );
+
+				Map(const Map&);
+				void operator = (const Map&);
+
 			protected:
 
-				Port ports[FULL_SIZE];
+				struct Page
+				{
+					const byte* const* mem;
+					dword memMask;
+					Port* ports;
+					uint mask;
+					ibool dirty;
+					const byte* const* bound;
+					dword boundMask;
+					const byte* fixed;
+					Port port;
+					Port boundPort;
+				};
+
+				Page pages[NUM_PAGES];
+				ibool dirty;
+
+			private:
+
+				static void Release(Page& page)
+				{
+					if (page.ports != &page.port)
+						delete [] page.ports;
+				}
+
+				void Touch(Page& page)
+				{
+					page.mem = NULL;
+					page.dirty = true;
+					dirty = true;
+				}
+
+				static void Expand(Page& page)
+				{
+					if (page.mask != PAGE_MASK)
+					{
+						Port* const ports = new Port [PAGE_SIZE];
+
+						for (uint i=0; i < PAGE_SIZE; ++i)
+							ports[i] = page.ports[i & page.mask];
+
+						Release( page );
+
+						page.ports = ports;
+						page.mask = PAGE_MASK;
+					}
+				}
+
+				static void Compact(Page& page)
+				{
+					for (uint n=1; n <= page.mask; n <<= 1)
+					{
+						uint i = n;
+
+						while (i <= page.mask && page.ports[i] == page.ports[i & (n-1)])
+							++i;
+
+						if (i > page.mask)
+						{
+							Port* ports;
+
+							if (n == 1)
+							{
+								page.port = page.ports[0];
+								ports = &page.port;
+							}
+							else
+							{
+								ports = new Port [n];
+
+								for (i=0; i < n; ++i)
+									ports[i] = page.ports[i];
+							}
+
+							Release( page );
+
+							page.ports = ports;
+							page.mask = n - 1;
+							break;
+						}
+					}
+				}
+
+				static void Validate(Page& page)
+				{
+					page.mem = NULL;
+
+					if (page.bound)
+					{
+						for (uint i=0; i <= page.mask; ++i)
+						{
+							if (!page.ports[i].SamePeek( page.boundPort ))
+								return;
+						}
+
+						page.mem = page.bound;
+						page.memMask = page.boundMask;
+					}
+				}
+
+				Address Split(Address address,Address last,Port*& begin,const Port*& end)
+				{
+					Page& page = pages[address >> PAGE_SHIFT];
+					const Address next = (address | PAGE_MASK) + 1;
+
+					Touch( page );
+
+					if ((address & PAGE_MASK) == 0 && last >= next - 1)
+					{
+						begin = page.ports;
+						end = page.ports + page.mask + 1;
+					}
+					else
+					{
+						Expand( page );
+
+						begin = page.ports + (address & PAGE_MASK);
+						end = page.ports + ((last < next ? last : next - 1) & PAGE_MASK) + 1;
+					}
+
+					return next;
+				}
+
+				void Bind(Address first,Address last,const byte* const* banks,const byte* mem,dword size)
+				{
+					NST_ASSERT
+					(
+						first <= last && last < SIZE && size >= PAGE_SIZE && !(size & (size-1)) &&
+						!(first & PAGE_MASK) && (last & PAGE_MASK) == PAGE_MASK
+					);
+
+					for (Address address=first; address <= last; address += PAGE_SIZE)
+					{
+						Page& page = pages[address >> PAGE_SHIFT];
+
+						if (banks)
+						{
+							page.bound = banks + (address - first) / size;
+						}
+						else
+						{
+							page.fixed = mem;
+							page.bound = &page.fixed;
+						}
+
+						page.boundMask = size - 1;
+						page.boundPort = page.ports[0];
+
+						Touch( page );
+					}
+				}
 
 			public:
 
 				class Section
 				{
-					Port* NST_RESTRICT port;
-					const Port* const end;
+					Map& map;
+					const Address first;
+					const Address last;
 
 				public:
 
-					Section(Port* b,const Port* e)
-					: port(b), end(e) {}
+					Section(Map& m,Address f,Address l)
+					: map(m), first(f), last(l) {}
 
 					template<typename A,typename B,typename C>
 					void Set(A a,B b,C c)
 					{
-						do
+						for (Address address=first; address <= last; )
 						{
-							port->Set( a, b, c );
+							Port* port;
+							const Port* end;
+
+							address = map.Split( address, last, port, end );
+
+							do
+							{
+								port->Set( a, b, c );
+							}
+							while (++port != end);
 						}
-						while (++port != end);
 					}
 
 					template<typename A,typename B>
 					void Set(A a,B b)
 					{
-						do
+						for (Address address=first; address <= last; )
 						{
-							port->Set( a, b );
+							Port* port;
+							const Port* end;
+
+							address = map.Split( address, last, port, end );
+
+							do
+							{
+								port->Set( a, b );
+							}
+							while (++port != end);
 						}
-						while (++port != end);
 					}
 
 					template<typename A>
 					void Set(A a)
 					{
-						do
+						for (Address address=first; address <= last; )
 						{
-							port->Set( a );
+							Port* port;
+							const Port* end;
+
+							address = map.Split( address, last, port, end );
+
+							do
+							{
+								port->Set( a );
+							}
+							while (++port != end);
 						}
-						while (++port != end);
+					}
+
+					// The ports currently in the section read banks[i][address & (size-1)],
+					// banks[i] being the bank of size bytes that address falls in. The
+					// pointers are followed on every read so the banks may be swapped freely.
+
+					void Bind(const byte* const* banks,dword size) const
+					{
+						map.Bind( first, last, banks, NULL, size );
+					}
+
+					// The ports currently in the section read mem[address & (size-1)]
+
+					void Bind(const byte* mem,dword size) const
+					{
+						map.Bind( first, last, NULL, mem, size );
 					}
 				};
 
 				template<typename A,typename B,typename C>
 				Map(A a,B b,C c)
+				: dirty(false)
+				{
+					for (uint i=0; i < NUM_PAGES; ++i)
+					{
+						Page& page = pages[i];
+
+						page.mem = NULL;
+						page.memMask = 0;
+						page.ports = &page.port;
+						page.mask = 0;
+						page.dirty = false;
+						page.bound = NULL;
+						page.boundMask = 0;
+						page.fixed = NULL;
+					}
+
+					pages[NUM_PAGES-1].port.Set( a, b, c );
+				}
+
+				~Map()
 				{
-					for (dword i=SIZE; i < FULL_SIZE; ++i)
-						ports[i].Set( a, b, c );
+					for (uint i=0; i < NUM_PAGES; ++i)
+						Release( pages[i] );
 				}
 
 				const Port& operator [] (Address address) const
 				{
 					NST_ASSERT( address < FULL_SIZE );
-					return ports[address];
+
+					const Page& page = pages[address >> PAGE_SHIFT];
+					return page.ports[address & page.mask];
 				}
 
 				Port& operator () (Address address)
 				{
 					NST_ASSERT( address < FULL_SIZE );
-					return ports[address];
+
+					Page& page = pages[address >> PAGE_SHIFT];
+
+					Touch( page );
+					Expand( page );
+
+					return page.ports[address & PAGE_MASK];
 				}
 
 				Section operator () (Address first,Address last)
 				{
 					NST_ASSERT( first <= last && last < SIZE );
-					return Section( ports + first, ports + last + 1 );
+					return Section( *this, first, last );
+				}
+
+				void Unbind()
+				{
+					for (uint i=0; i < NUM_PAGES; ++i)
+					{
+						pages[i].mem = NULL;
+						pages[i].bound = NULL;
+					}
+				}
+
+				void Update()
+				{
+					if (dirty)
+					{
+						dirty = false;
+
+						for (uint i=0; i < NUM_PAGES; ++i)
+						{
+							Page& page = pages[i];
+
+							if (page.dirty)
+							{
+								page.dirty = false;
+
+								Compact( page );
+								Validate( page );
+							}
+						}
+					}
 				}
 			};
 		}
@@ -117,6 +117,11 @@ namespace Nes
 				{
 					return component == p.component && reader == p.reader && writer == p.writer;
 				}
+
+				bool SamePeek(const Port& p) const
+				{
+					return component == p.component && reader == p.reader;
+				}
 			};
 
 			#define NES_DECL_PEEK(a_) Data NST_FASTCALL Peek_##a_(Address)
@@ -193,6 +198,11 @@ namespace Nes
 				{
 					return component == p.component && reader == p.reader && writer == p.writer;
 				}
+
+				bool SamePeek(const Port& p) const
+				{
+					return component == p.component && reader == p.reader;
+				}
 			};
 
 			#define NES_DECL_PEEK(a_)                                                        \
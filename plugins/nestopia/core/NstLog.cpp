@@ -27,7 +27,7 @@
 #include <string>
 #include "NstAssert.hpp"
 #include "NstLog.hpp"
-#include "api/NstApiUser.hpp"
+#include "NstCallbacks.hpp"
 
 namespace Nes
 {
@@ -42,10 +42,10 @@ namespace Nes
 			std::string string;
 		};
 
-		bool Log::enabled = true;
+		thread_local bool Log::enabled = true;
 
 		Log::Log()
-		: object( !Api::User::logCallback ? NULL : new (std::nothrow) Object )
+		: object( !Callbacks::Current().user.logCallback ? NULL : new (std::nothrow) Object )
 		{
 		}
 
@@ -54,7 +54,7 @@ namespace Nes
 			if (object)
 			{
 				if (enabled)
-					Api::User::logCallback( object->string.c_str(), object->string.size() );
+					Callbacks::Current().user.logCallback( object->string.c_str(), object->string.size() );
 
 				delete object;
 			}
@@ -62,7 +62,7 @@ namespace Nes
 
 		bool Log::Available()
 		{
-			return Api::User::logCallback;
+			return Callbacks::Current().user.logCallback;
 		}
 
 		void Log::Append(cstring c,ulong n)
@@ -140,7 +140,7 @@ namespace Nes
 		void Log::Flush(cstring string,dword length)
 		{
 			if (enabled)
-				Api::User::logCallback( string, length );
+				Callbacks::Current().user.logCallback( string, length );
 		}
 
 		#ifdef NST_MSVC_OPTIMIZE
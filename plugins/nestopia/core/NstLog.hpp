@@ -80,7 +80,7 @@ namespace Nes
 			struct Object;
 			Object* const object;
 
-			static bool enabled;
+			static thread_local bool enabled;
 
 		public:
 
@@ -0,0 +1,234 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include "NstAssert.hpp"
+#include "NstLz.hpp"
+
+namespace Nes
+{
+	namespace Core
+	{
+		namespace Lz
+		{
+			/*
+			* A stream of sequences, each a token byte holding a literal count
+			* in its high nibble and a match length minus MIN_MATCH in its low
+			* nibble, either extended by bytes of 255 and a final byte when
+			* the nibble is 15. The literals follow, then a 16 bit offset back
+			* to the match. The last sequence has literals only.
+			*/
+
+			enum
+			{
+				MIN_MATCH = 4,
+				MAX_OFFSET = 0xFFFF,
+				HASH_BITS = 12,
+				HASH_SIZE = 1U << HASH_BITS,
+				RUN_MASK = 0xF
+			};
+
+			static inline dword Read32(const byte* p)
+			{
+				return p[0] | uint(p[1]) << 8 | dword(p[2]) << 16 | dword(p[3]) << 24;
+			}
+
+			static inline uint Hash(dword value)
+			{
+				return (value * 2654435761U) >> (32 - HASH_BITS) & (HASH_SIZE - 1);
+			}
+
+			static inline bool PutLength(byte*& dst,const byte* const dstEnd,ulong length)
+			{
+				for (; length >= 0xFF; length -= 0xFF)
+				{
+					if (dst == dstEnd)
+						return false;
+
+					*dst++ = 0xFF;
+				}
+
+				if (dst == dstEnd)
+					return false;
+
+				*dst++ = length;
+				return true;
+			}
+
+			static inline bool GetLength(const byte*& src,const byte* const srcEnd,ulong& length)
+			{
+				for (;;)
+				{
+					if (src == srcEnd)
+						return false;
+
+					const uint next = *src++;
+					length += next;
+
+					if (next != 0xFF)
+						return true;
+				}
+			}
+
+			static bool PutSequence(byte*& dst,const byte* const dstEnd,const byte* literals,const ulong numLiterals,const ulong matchLength,const uint offset)
+			{
+				if (dst == dstEnd)
+					return false;
+
+				byte* const token = dst++;
+				*token = (NST_MIN(numLiterals,ulong(RUN_MASK)) << 4);
+
+				if (numLiterals >= RUN_MASK && !PutLength( dst, dstEnd, numLiterals - RUN_MASK ))
+					return false;
+
+				if (ulong(dstEnd - dst) < numLiterals)
+					return false;
+
+				std::memcpy( dst, literals, numLiterals );
+				dst += numLiterals;
+
+				if (matchLength)
+				{
+					const ulong length = matchLength - MIN_MATCH;
+					*token |= NST_MIN(length,ulong(RUN_MASK));
+
+					if (dstEnd - dst < 2)
+						return false;
+
+					dst[0] = offset & 0xFF;
+					dst[1] = offset >> 8;
+					dst += 2;
+
+					if (length >= RUN_MASK && !PutLength( dst, dstEnd, length - RUN_MASK ))
+						return false;
+				}
+
+				return true;
+			}
+
+			ulong Compress(const byte* const src,const ulong srcSize,byte* const dst,const ulong dstSize)
+			{
+				NST_ASSERT( (src || !srcSize) && (dst || !dstSize) );
+
+				if (!srcSize || !dstSize)
+					return 0;
+
+				dword table[HASH_SIZE];
+				std::memset( table, 0, sizeof(table) );
+
+				const byte* const srcEnd = src + srcSize;
+				const byte* const matchLimit = srcSize > MIN_MATCH ? srcEnd - MIN_MATCH : src;
+				const byte* anchor = src;
+				const byte* ip = src;
+
+				byte* op = dst;
+				byte* const dstEnd = dst + dstSize;
+
+				while (ip < matchLimit)
+				{
+					const dword value = Read32( ip );
+					const uint hash = Hash( value );
+					const dword candidate = table[hash];
+					table[hash] = dword(ip - src) + 1;
+
+					if (candidate)
+					{
+						const byte* const match = src + (candidate - 1);
+						const uint offset = ip - match;
+
+						if (offset <= MAX_OFFSET && Read32( match ) == value)
+						{
+							const byte* end = ip + MIN_MATCH;
+
+							while (end < srcEnd && *end == match[end - ip])
+								++end;
+
+							if (!PutSequence( op, dstEnd, anchor, ip - anchor, end - ip, offset ))
+								return 0;
+
+							ip = anchor = end;
+							continue;
+						}
+					}
+
+					++ip;
+				}
+
+				if (!PutSequence( op, dstEnd, anchor, srcEnd - anchor, 0, 0 ))
+					return 0;
+
+				return op - dst;
+			}
+
+			ulong Uncompress(const byte* src,const ulong srcSize,byte* const dst,const ulong dstSize)
+			{
+				NST_ASSERT( (src || !srcSize) && (dst || !dstSize) );
+
+				const byte* const srcEnd = src + srcSize;
+				byte* op = dst;
+				byte* const dstEnd = dst + dstSize;
+
+				while (src != srcEnd)
+				{
+					const uint token = *src++;
+					ulong length = token >> 4;
+
+					if (length == RUN_MASK && !GetLength( src, srcEnd, length ))
+						return 0;
+
+					if (ulong(srcEnd - src) < length || ulong(dstEnd - op) < length)
+						return 0;
+
+					std::memcpy( op, src, length );
+					op += length;
+					src += length;
+
+					if (src == srcEnd)
+						break;
+
+					if (srcEnd - src < 2)
+						return 0;
+
+					const uint offset = src[0] | uint(src[1]) << 8;
+					src += 2;
+
+					length = token & RUN_MASK;
+
+					if (length == RUN_MASK && !GetLength( src, srcEnd, length ))
+						return 0;
+
+					length += MIN_MATCH;
+
+					if (!offset || ulong(op - dst) < offset || ulong(dstEnd - op) < length)
+						return 0;
+
+					for (const byte* match = op - offset; length; --length)
+						*op++ = *match++;
+				}
+
+				return op - dst;
+			}
+		}
+	}
+}
@@ -79,6 +79,8 @@ namespace Nes
 			uint type
 		)
 		{
+			Callbacks::Scope scope( callbacks );
+
 			Unload();
 
 			Image::Context context
@@ -93,7 +95,8 @@ namespace Nes
 				patchResult,
 				system,
 				ask,
-				imageDatabase
+				imageDatabase,
+				fdsBios.Rom()
 			);
 
 			image = Image::Load( context );
@@ -131,13 +134,15 @@ namespace Nes
 
 			UpdateModels();
 
-			Api::Machine::eventCallback( Api::Machine::EVENT_LOAD, context.result );
+			callbacks.machine.eventCallback( Api::Machine::EVENT_LOAD, context.result );
 
 			return context.result;
 		}
 
 		Result Machine::Unload()
 		{
+			Callbacks::Scope scope( callbacks );
+
 			if (!image)
 				return RESULT_OK;
 
@@ -150,7 +155,7 @@ namespace Nes
 
 			state &= (Api::Machine::NTSC|Api::Machine::PAL);
 
-			Api::Machine::eventCallback( Api::Machine::EVENT_UNLOAD, result );
+			callbacks.machine.eventCallback( Api::Machine::EVENT_UNLOAD, result );
 
 			return result;
 		}
@@ -234,6 +239,8 @@ namespace Nes
 
 		Result Machine::PowerOff(Result result)
 		{
+			Callbacks::Scope scope( callbacks );
+
 			if (state & Api::Machine::ON)
 			{
 				tracker.PowerOff();
@@ -247,7 +254,7 @@ namespace Nes
 				state &= ~uint(Api::Machine::ON);
 				frame = 0;
 
-				Api::Machine::eventCallback( Api::Machine::EVENT_POWER_OFF, result );
+				callbacks.machine.eventCallback( Api::Machine::EVENT_POWER_OFF, result );
 			}
 
 			return result;
@@ -255,6 +262,8 @@ namespace Nes
 
 		void Machine::Reset(bool hard)
 		{
+			Callbacks::Scope scope( callbacks );
+
 			if (state & Api::Machine::SOUND)
 				hard = true;
 
@@ -306,12 +315,12 @@ namespace Nes
 
 				if (state & Api::Machine::ON)
 				{
-					Api::Machine::eventCallback( hard ? Api::Machine::EVENT_RESET_HARD : Api::Machine::EVENT_RESET_SOFT );
+					callbacks.machine.eventCallback( hard ? Api::Machine::EVENT_RESET_HARD : Api::Machine::EVENT_RESET_SOFT );
 				}
 				else
 				{
 					state |= Api::Machine::ON;
-					Api::Machine::eventCallback( Api::Machine::EVENT_POWER_ON );
+					callbacks.machine.eventCallback( Api::Machine::EVENT_POWER_ON );
 				}
 			}
 			catch (...)
@@ -323,6 +332,8 @@ namespace Nes
 
 		void Machine::SwitchMode()
 		{
+			Callbacks::Scope scope( callbacks );
+
 			NST_ASSERT( !(state & Api::Machine::ON) );
 
 			if (state & Api::Machine::NTSC)
@@ -332,7 +343,7 @@ namespace Nes
 
 			UpdateModels();
 
-			Api::Machine::eventCallback( (state & Api::Machine::NTSC) ? Api::Machine::EVENT_MODE_NTSC : Api::Machine::EVENT_MODE_PAL );
+			callbacks.machine.eventCallback( (state & Api::Machine::NTSC) ? Api::Machine::EVENT_MODE_NTSC : Api::Machine::EVENT_MODE_PAL );
 		}
 
 		void Machine::InitializeInputDevices() const
@@ -346,8 +357,21 @@ namespace Nes
 			}
 		}
 
+		bool Machine::IsLightGunConnected() const
+		{
+			for (uint i=0, n=extPort->NumPorts(); i < n; ++i)
+			{
+				if (extPort->GetDevice( i ).GetType() == Api::Input::ZAPPER)
+					return true;
+			}
+
+			return expPort->GetType() == Api::Input::BANDAIHYPERSHOT;
+		}
+
 		void Machine::SaveState(State::Saver& saver) const
 		{
+			Callbacks::Scope scope( callbacks );
+
 			NST_ASSERT( (state & (Api::Machine::GAME|Api::Machine::ON)) > Api::Machine::ON );
 
 			saver.Begin( AsciiId<'N','S','T'>::V | 0x1AUL << 24 );
@@ -380,6 +404,8 @@ namespace Nes
 
 		bool Machine::LoadState(State::Loader& loader,const bool resetOnError)
 		{
+			Callbacks::Scope scope( callbacks );
+
 			NST_ASSERT( (state & (Api::Machine::GAME|Api::Machine::ON)) > Api::Machine::ON );
 
 			try
@@ -399,7 +425,7 @@ namespace Nes
 							(
 								loader.CheckCrc() && !(state & Api::Machine::DISK) &&
 								crc && crc != image->GetPrgCrc() &&
-								Api::User::questionCallback( Api::User::QUESTION_NST_PRG_CRC_FAIL_CONTINUE ) == Api::User::ANSWER_NO
+								callbacks.user.questionCallback( Api::User::QUESTION_NST_PRG_CRC_FAIL_CONTINUE ) == Api::User::ANSWER_NO
 							)
 							{
 								for (uint i=0; i < 2; ++i)
@@ -492,6 +518,8 @@ namespace Nes
 			Input::Controllers* const input
 		)
 		{
+			Callbacks::Scope scope( callbacks );
+
 			NST_ASSERT( state & Api::Machine::ON );
 
 			if (!(state & Api::Machine::SOUND))
@@ -502,7 +530,7 @@ namespace Nes
 				extPort->BeginFrame( input );
 				expPort->BeginFrame( input );
 
-				ppu.BeginFrame( tracker.IsFrameLocked() );
+				ppu.BeginFrame( tracker.IsFrameLocked(), video || IsLightGunConnected() );
 
 				if (cheats)
 					cheats->BeginFrame( tracker.IsFrameLocked() );
@@ -30,6 +30,8 @@
 #include "NstPpu.hpp"
 #include "NstTracker.hpp"
 #include "NstVideoRenderer.hpp"
+#include "NstFds.hpp"
+#include "NstCallbacks.hpp"
 
 #ifdef NST_PRAGMA_ONCE
 #pragma once
@@ -105,6 +107,7 @@ namespace Nes
 		private:
 
 			void UpdateModels();
+			bool IsLightGunConnected() const;
 			Result UpdateVideo(PpuModel,ColorMode);
 			ColorMode GetColorMode() const;
 
@@ -128,6 +131,8 @@ namespace Nes
 			Image* image;
 			Cheats* cheats;
 			ImageDatabase* imageDatabase;
+			Callbacks callbacks;
+			Fds::Bios fdsBios;
 			Tracker tracker;
 			Cpu cpu;
 			Ppu ppu;
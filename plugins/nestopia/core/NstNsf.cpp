@@ -30,7 +30,7 @@
 #include "board/NstBoardKonami.hpp"
 #include "board/NstBoardNamcot.hpp"
 #include "board/NstBoardSunsoft.hpp"
-#include "api/NstApiNsf.hpp"
+#include "NstCallbacks.hpp"
 #include "NstNsf.hpp"
 
 namespace Nes
@@ -559,7 +559,7 @@ namespace Nes
 						apu.ClearBuffers();
 					}
 
-					Api::Nsf::eventCallback( Api::Nsf::EVENT_SELECT_SONG );
+					Callbacks::Current().nsf.eventCallback( Api::Nsf::EVENT_SELECT_SONG );
 
 					return RESULT_OK;
 				}
@@ -577,7 +577,7 @@ namespace Nes
 				routine.nmi = Routine::NMI;
 				routine.playing = true;
 
-				Api::Nsf::eventCallback( Api::Nsf::EVENT_PLAY_SONG );
+				Callbacks::Current().nsf.eventCallback( Api::Nsf::EVENT_PLAY_SONG );
 
 				return RESULT_OK;
 			}
@@ -593,7 +593,7 @@ namespace Nes
 				routine.nmi = Routine::NMI;
 				apu.ClearBuffers();
 
-				Api::Nsf::eventCallback( Api::Nsf::EVENT_STOP_SONG );
+				Callbacks::Current().nsf.eventCallback( Api::Nsf::EVENT_STOP_SONG );
 
 				return RESULT_OK;
 			}
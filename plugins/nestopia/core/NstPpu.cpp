@@ -27,6 +27,10 @@
 #include "NstPpu.hpp"
 #include "NstState.hpp"
 
+#ifdef NST_MM_INTRINSICS
+#include <emmintrin.h>
+#endif
+
 namespace Nes
 {
 	namespace Core
@@ -97,8 +101,19 @@ namespace Nes
 				block[i][2] = (i & 0x0C) ? (i >> 6 & 0xC) | (i >> 2 & 0x3) : 0;
 				block[i][3] = (i & 0x03) ? (i >> 6 & 0xC) | (i >> 0 & 0x3) : 0;
 			}
+
+			for (uint i=0; i < 0x100; ++i)
+			{
+				for (uint j=0; j < 8; ++j)
+				{
+					row[0][i][j] = i >> (7-j) & 0x1;
+					row[1][i][j] = i >> j & 0x1;
+				}
+			}
 		}
 
+		const Ppu::TileLut Ppu::tileLut;
+
 		Ppu::Ppu(Cpu& c)
 		:
 		cpu    (c),
@@ -171,6 +186,7 @@ namespace Nes
 				}
 
 				cpu.Map( 0x4014U ).Set( this, &Ppu::Peek_4014, &Ppu::Poke_4014 );
+				cpu.SetIdlePort( 0x2002, Hook(this,&Ppu::Hook_Poll) );
 			}
 
 			if (hard)
@@ -287,11 +303,13 @@ namespace Nes
 		void Ppu::SetHActiveHook(const Hook& hook)
 		{
 			hActiveHook = hook;
+			ScheduleSync();
 		}
 
 		void Ppu::SetHBlankHook(const Hook& hook)
 		{
 			hBlankHook = hook;
+			ScheduleSync();
 		}
 
 		void Ppu::UpdateStates()
@@ -305,6 +323,7 @@ namespace Nes
 			oam.show[1] = (regs.ctrl[1] & Regs::CTRL1_SP_ENABLED_NO_CLIP) == Regs::CTRL1_SP_ENABLED_NO_CLIP ? 0xFF : 0x00;
 
 			UpdatePalette();
+			ScheduleSync();
 		}
 
 		void Ppu::UpdatePalette()
@@ -413,7 +432,8 @@ namespace Nes
 
 		void Ppu::EnableCpuSynchronization()
 		{
-			cpu.AddHook( Hook(this,&Ppu::Hook_Sync) );
+			cpu.AddEvent( Hook(this,&Ppu::Hook_Sync) );
+			ScheduleSync();
 		}
 
 		void Ppu::ChrMem::ResetAccessor()
@@ -484,7 +504,7 @@ namespace Nes
 			return cycles.one == PPU_RP2C02_CC ? clock / PPU_RP2C02_CC : (clock+PPU_RP2C07_CC-1) / PPU_RP2C07_CC;
 		}
 
-		void Ppu::BeginFrame(bool frameLock)
+		void Ppu::BeginFrame(bool frameLock,bool render)
 		{
 			NST_ASSERT
 			(
@@ -495,7 +515,11 @@ namespace Nes
 			);
 
 			oam.limit = oam.buffer + ((oam.spriteLimit || frameLock) ? Oam::STD_LINE_SPRITES*4 : Oam::MAX_LINE_SPRITES*4);
-			output.target = output.pixels;
+
+			// A frame that is neither shown nor captured into some other
+			// buffer, as the rewinder does, is run without pixel output.
+
+			output.target = (render || output.pixels != screen.pixels) ? output.pixels : NULL;
 
 			Cycle frame;
 
@@ -555,6 +579,8 @@ namespace Nes
 			}
 
 			cpu.SetFrameCycles( frame );
+
+			ScheduleSync();
 		}
 
 		NES_HOOK(Ppu,Sync)
@@ -566,6 +592,159 @@ namespace Nes
 				cycles.count = GetLocalCycles( elapsed ) - cycles.vClock;
 				Run();
 			}
+
+			ScheduleSync();
+		}
+
+		void Ppu::ScheduleSync()
+		{
+			cpu.ScheduleEvent( Hook(this,&Ppu::Hook_Sync), GetSyncClock() );
+		}
+
+		Cycle Ppu::GetSyncClock() const
+		{
+			// The CPU only has to wait for a rising A12 edge from rendering,
+			// as the mapper may raise its IRQ on it, and for the NMI at the
+			// end of the frame. Find the earliest dot either could possibly
+			// occur on. Register writes that change any of the inputs below
+			// reschedule.
+
+			if (cycles.count == Cpu::CYCLE_MAX)
+				return Cpu::CYCLE_MAX;
+
+			if (hActiveHook || hBlankHook)
+				return cycles.count;
+
+			const Cycle frame = cpu.GetFrameCycles();
+
+			if (!io.line || !(regs.ctrl[1] & Regs::CTRL1_BG_SP_ENABLED))
+				return frame;
+
+			if ((regs.ctrl[0] << 8 | io.pattern) & 0x1000)
+				return cycles.count;
+
+			uint next;
+
+			if (cycles.hClock < 256)
+			{
+				next = 256;
+			}
+			else if (cycles.hClock < 320)
+			{
+				return cycles.count;
+			}
+			else if (cycles.hClock < HCLOCK_DUMMY)
+			{
+				next = 340 + 256;
+			}
+			else if (cycles.hClock < HCLOCK_DUMMY+256)
+			{
+				next = HCLOCK_DUMMY+256;
+			}
+			else if (cycles.hClock < HCLOCK_VBLANK_0)
+			{
+				return cycles.count;
+			}
+			else
+			{
+				return frame;
+			}
+
+			return NST_MIN( (cycles.vClock + next) * cycles.one, frame );
+		}
+
+		NES_HOOK(Ppu,Poll)
+		{
+			cpu.HoldIdlePort( GetPollClock() );
+		}
+
+		Cycle Ppu::GetPollClock() const
+		{
+			// Returns the last cycle up to which a $2002 read still returns
+			// what the previous one did. That one may have cleared the vblank
+			// flag, which then can't come back before the end of line 239.
+			// Sprite zero hit and overflow are cleared on the pre-render line
+			// and only get set on the lines the sprites are on. Anything else
+			// comes from the CPU.
+
+			const uint status = regs.status & Regs::STATUS_BITS;
+
+			if (cycles.count == Cpu::CYCLE_MAX || (io.latch & Regs::STATUS_BITS) != status)
+				return 0;
+			int line;
+			uint line0;
+
+			if (cycles.hClock >= HCLOCK_DUMMY && cycles.hClock < HCLOCK_VBLANK_0)
+			{
+				if (scanline == SCANLINE_VBLANK && status)
+					return (cycles.vClock + HCLOCK_DUMMY - 2) * cycles.one;
+
+				line = -1;
+				line0 = cycles.vClock + HCLOCK_DUMMY + 340;
+			}
+			else if (cycles.hClock < HCLOCK_DUMMY && scanline == SCANLINE_HDUMMY)
+			{
+				line = -1;
+				line0 = cycles.vClock + 340;
+			}
+			else if (cycles.hClock < HCLOCK_DUMMY && scanline >= 0 && scanline < SCANLINE_VBLANK)
+			{
+				line = scanline;
+				line0 = cycles.vClock - scanline * 341;
+			}
+			else
+			{
+				return 0;
+			}
+
+			uint next = line0 + 239 * 341 + HCLOCK_VBLANK_0;
+
+			if (regs.ctrl[1] & Regs::CTRL1_BG_SP_ENABLED)
+			{
+				if (regs.oam)
+					return 0;
+
+				if (!(status & Regs::STATUS_SP_ZERO_HIT) && oam.ram[0] < SCANLINE_VBLANK)
+				{
+					const int first = oam.ram[0];
+
+					if (line >= first && line <= first + int(oam.height))
+						return 0;
+
+					if (line < first)
+						next = NST_MIN( next, line0 + first * 341 );
+				}
+
+				if (!(status & Regs::STATUS_SP_OVERFLOW))
+				{
+					int sprites[SCANLINE_VBLANK+1] = {0};
+
+					for (uint i=0; i < Oam::SIZE; i += 4)
+					{
+						if (oam.ram[i] < SCANLINE_VBLANK)
+						{
+							sprites[oam.ram[i]]++;
+							sprites[NST_MIN( oam.ram[i] + oam.height, uint(SCANLINE_VBLANK) )]--;
+						}
+					}
+
+					for (int i=0, n=0; i < SCANLINE_VBLANK; ++i)
+					{
+						n += sprites[i];
+
+						if (n >= 8 && i >= line)
+						{
+							if (i == line)
+								return 0;
+
+							next = NST_MIN( next, line0 + i * 341 );
+							break;
+						}
+					}
+				}
+			}
+
+			return (next - 2) * cycles.one;
 		}
 
 		void Ppu::EndFrame()
@@ -774,6 +953,8 @@ namespace Nes
 					if (clock < GetHVIntClock())
 						cpu.DoNMI( clock );
 				}
+
+				ScheduleSync();
 			}
 		}
 
@@ -806,6 +987,8 @@ namespace Nes
 				data = (regs.ctrl[1] ^ data) & (Regs::CTRL1_EMPHASIS|Regs::CTRL1_MONOCHROME);
 				regs.ctrl[1] = io.latch;
 
+				ScheduleSync();
+
 				if (data)
 				{
 					const uint ce[] = { Coloring(), Emphasis() };
@@ -1126,7 +1309,7 @@ namespace Nes
 			dst[7] = src[1][3];
 		}
 
-		NST_SINGLE_CALL void Ppu::LoadTiles()
+		NST_FORCE_INLINE void Ppu::LoadTiles()
 		{
 			const byte* const NST_RESTRICT src[] =
 			{
@@ -1309,24 +1492,14 @@ namespace Nes
 		{
 			if (pattern0 | pattern1)
 			{
-				uint a = (buffer[2] & uint(Oam::X_FLIP)) ? 7 : 0;
-
-				uint p =
-				(
-					(pattern0 >> 1 & 0x0055) | (pattern1 << 0 & 0x00AA) |
-					(pattern0 << 8 & 0x5500) | (pattern1 << 9 & 0xAA00)
-				);
+				const byte (&rows)[0x100][8] = tileLut.row[(buffer[2] & uint(Oam::X_FLIP)) ? 1 : 0];
+				const byte* const NST_RESTRICT plane0 = rows[pattern0];
+				const byte* const NST_RESTRICT plane1 = rows[pattern1];
 
 				Oam::Output* const NST_RESTRICT entry = oam.visible++;
 
-				entry->pixels[( a^=6 )] = ( p       ) & 0x3;
-				entry->pixels[( a^=2 )] = ( p >>= 2 ) & 0x3;
-				entry->pixels[( a^=6 )] = ( p >>= 2 ) & 0x3;
-				entry->pixels[( a^=2 )] = ( p >>= 2 ) & 0x3;
-				entry->pixels[( a^=7 )] = ( p >>= 2 ) & 0x3;
-				entry->pixels[( a^=2 )] = ( p >>= 2 ) & 0x3;
-				entry->pixels[( a^=6 )] = ( p >>= 2 ) & 0x3;
-				entry->pixels[( a^=2 )] = ( p >>= 2 );
+				for (uint i=0; i < 8; ++i)
+					entry->pixels[i] = plane0[i] | plane1[i] << 1;
 
 				const uint attribute = buffer[2];
 
@@ -1358,8 +1531,30 @@ namespace Nes
 			while (buffer != oam.buffered);
 		}
 
+		NST_FORCE_INLINE void Ppu::TestSpriteZero()
+		{
+			// RenderPixel() for frames nobody will see. Sprite 0 is first in
+			// line if it's there at all, so only the background can hide it.
+
+			const uint clock = cycles.hClock++;
+
+			if (oam.visible != oam.output && oam.output->zero)
+			{
+				const uint x = clock - oam.output->x;
+
+				if (x <= 7 && (oam.output->pixels[x] & oam.mask) && (tiles.pixels[(clock + scroll.xFine) & 15] & tiles.mask))
+					regs.status |= Regs::STATUS_SP_ZERO_HIT;
+			}
+		}
+
 		NST_FORCE_INLINE void Ppu::RenderPixel()
 		{
+			if (!output.target)
+			{
+				TestSpriteZero();
+				return;
+			}
+
 			uint clock;
 			uint pixel = tiles.pixels[((clock=cycles.hClock++) + scroll.xFine) & 15] & tiles.mask;
 
@@ -1391,6 +1586,10 @@ namespace Nes
 		NST_SINGLE_CALL void Ppu::RenderPixel255()
 		{
 			cycles.hClock = 256;
+
+			if (!output.target)
+				return;
+
 			uint pixel = tiles.pixels[(255 + scroll.xFine) & 15] & tiles.mask;
 
 			for (const Oam::Output* NST_RESTRICT sprite=oam.output, *const end=oam.visible; sprite != end; ++sprite)
@@ -1415,6 +1614,169 @@ namespace Nes
 			*target = output.palette[pixel];
 		}
 
+		void Ppu::RenderScanline()
+		{
+			// Dots 0-255 of a visible line in one go, for when all of them are
+			// due and no address line is watching. The fetches are made in the
+			// same order as in Run(), so boards hooking the accessors can't
+			// tell the difference. Background and sprite evaluation don't
+			// depend on each other, and the pixels are composited at the end.
+
+			NST_ASSERT( cycles.hClock == 0 && tiles.index == 8 && !io.line );
+
+			byte bg[8+256];
+
+			std::memcpy( bg, tiles.pixels, 8 );
+
+			for (uint i=8; i < 8+256; i += 8)
+			{
+				LoadTiles();
+				std::memcpy( bg + i, tiles.pixels + (tiles.index ^ 8U), 8 );
+
+				OpenName();
+				FetchName();
+				OpenAttribute();
+				FetchAttribute();
+
+				if (i == 8+248)
+					scroll.ClockY();
+
+				scroll.ClockX();
+				OpenPattern( io.pattern | 0x0 );
+				FetchBgPattern0();
+				OpenPattern( io.pattern | 0x8 );
+				FetchBgPattern1();
+			}
+
+			if (oam.phase != &Ppu::EvaluateSpritesPhase0)
+			{
+				for (uint i=0; i < 32; ++i)
+					(*this.*oam.phase)();
+			}
+
+			NST_VERIFY( regs.oam == 0 );
+			oam.address = regs.oam & Oam::OFFSET_TO_0_1;
+			oam.phase = &Ppu::EvaluateSpritesPhase1;
+
+			for (uint i=96; i; --i)
+			{
+				if (oam.phase == &Ppu::EvaluateSpritesPhase9)
+				{
+					oam.address = (oam.address + (i-1) * 4) & 0xFF;
+					oam.latch = oam.ram[oam.address];
+					oam.address = (oam.address + 4) & 0xFF;
+					break;
+				}
+
+				oam.latch = oam.ram[oam.address];
+				(*this.*oam.phase)();
+			}
+
+			// Sprites are rasterized back to front into one row each of color,
+			// priority and sprite 0 flags, so only the front-most opaque pixel
+			// is left in every column, as with the search in RenderPixel().
+			// The masks are 0x00 or 0xFF and are applied up front.
+
+			byte* const NST_RESTRICT pixels = bg + scroll.xFine;
+
+			if (!tiles.mask)
+				std::memset( pixels, 0, 8 );
+
+			if (!tiles.show[0])
+				std::memset( pixels + 8, 0, 256-8 );
+
+			if (!output.target)
+			{
+				if (oam.visible != oam.output && oam.output->zero)
+				{
+					const Oam::Output& sprite = *oam.output;
+
+					for (uint x=0, n=NST_MIN(8U,255U-sprite.x); x < n; ++x)
+					{
+						if ((sprite.pixels[x] & (sprite.x + x < 8 ? oam.mask : oam.show[0])) && pixels[sprite.x + x])
+						{
+							regs.status |= Regs::STATUS_SP_ZERO_HIT;
+							break;
+						}
+					}
+				}
+			}
+			else if (oam.visible != oam.output && (oam.mask | oam.show[0]))
+			{
+				byte sp[3][256];
+				std::memset( sp, 0, sizeof(sp) );
+
+				for (const Oam::Output* NST_RESTRICT sprite=oam.visible; sprite-- != oam.output; )
+				{
+					for (uint x=0, n=NST_MIN(8U,256U-sprite->x); x < n; ++x)
+					{
+						if (const uint color = sprite->pixels[x])
+						{
+							sp[0][sprite->x + x] = sprite->palette + color;
+							sp[1][sprite->x + x] = sprite->behind ? 0xFF : 0x00;
+							sp[2][sprite->x + x] = sprite->zero ? 0xFF : 0x00;
+						}
+					}
+				}
+
+				if (!oam.mask)
+					std::memset( sp[0], 0, 8 );
+
+				if (!oam.show[0])
+					std::memset( sp[0] + 8, 0, 256-8 );
+
+				sp[2][255] = 0x00;
+
+			#ifdef NST_MM_INTRINSICS
+
+				const __m128i none = _mm_setzero_si128();
+				uint hit = 0;
+
+				for (uint x=0; x < 256; x += 16)
+				{
+					const __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i*>(pixels + x) );
+					const __m128i s = _mm_loadu_si128( reinterpret_cast<const __m128i*>(sp[0] + x) );
+					const __m128i bClear = _mm_cmpeq_epi8( b, none );
+					const __m128i sClear = _mm_cmpeq_epi8( s, none );
+
+					hit |= _mm_movemask_epi8( _mm_andnot_si128( _mm_or_si128( bClear, sClear ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(sp[2] + x) ) ) );
+
+					const __m128i keep = _mm_or_si128( sClear, _mm_andnot_si128( bClear, _mm_loadu_si128( reinterpret_cast<const __m128i*>(sp[1] + x) ) ) );
+					_mm_storeu_si128( reinterpret_cast<__m128i*>(pixels + x), _mm_or_si128( _mm_and_si128( keep, b ), _mm_andnot_si128( keep, s ) ) );
+				}
+
+				if (hit)
+					regs.status |= Regs::STATUS_SP_ZERO_HIT;
+
+			#else
+
+				for (uint x=0; x < 256; ++x)
+				{
+					if (const uint color = sp[0][x])
+					{
+						if (pixels[x] & sp[2][x])
+							regs.status |= Regs::STATUS_SP_ZERO_HIT;
+
+						if (!(pixels[x] & sp[1][x]))
+							pixels[x] = color;
+					}
+				}
+
+			#endif
+			}
+
+			if (Video::Screen::Pixel* const NST_RESTRICT target = output.target)
+			{
+				for (uint x=0; x < 256; ++x)
+					target[x] = output.palette[pixels[x]];
+
+				output.target += 256;
+			}
+			tiles.mask = tiles.show[0];
+			oam.mask = oam.show[0];
+			cycles.hClock = 256;
+		}
+
 		NST_NO_INLINE void Ppu::Run()
 		{
 			NST_VERIFY( cycles.count != cycles.hClock );
@@ -1424,6 +1786,18 @@ namespace Nes
 				switch (cycles.hClock)
 				{
 					case 0:
+					HActive0:
+
+						if (cycles.count >= 256 && tiles.index == 8 && !io.line)
+						{
+							RenderScanline();
+
+							if (cycles.count <= 256)
+								break;
+
+							goto HBlank;
+						}
+
 					case 8:
 					case 16:
 					case 24:
@@ -1775,6 +2149,7 @@ namespace Nes
 							break;
 
 					case 256:
+					HBlank:
 
 						OpenName();
 						oam.latch = 0xFF;
@@ -2087,7 +2462,7 @@ namespace Nes
 
 							cycles.count -= line;
 
-							goto HActive;
+							goto HActive0;
 						}
 						else
 						{
@@ -2645,8 +3020,6 @@ namespace Nes
 					case 255:
 					HActiveOff:
 					{
-						const uint pixel = output.palette[(scroll.address & 0x3F00) == 0x3F00 ? (scroll.address & 0x001F) : 0];
-
 						uint i = cycles.hClock;
 						const uint hClock = NST_MIN(cycles.count,256);
 						NST_ASSERT( i < hClock );
@@ -2655,17 +3028,26 @@ namespace Nes
 						tiles.index = (hClock - 1) & 8;
 
 						byte* const NST_RESTRICT tile = tiles.pixels;
-						Video::Screen::Pixel* NST_RESTRICT target = output.target;
 
-						do
+						if (Video::Screen::Pixel* NST_RESTRICT target = output.target)
+						{
+							const uint pixel = output.palette[(scroll.address & 0x3F00) == 0x3F00 ? (scroll.address & 0x001F) : 0];
+
+							do
+							{
+								tile[i++ & 15] = 0;
+								*target++ = pixel;
+							}
+							while (i != hClock);
+
+							output.target = target;
+						}
+						else do
 						{
 							tile[i++ & 15] = 0;
-							*target++ = pixel;
 						}
 						while (i != hClock);
 
-						output.target = target;
-
 						if (cycles.count <= 256)
 							break;
 					}
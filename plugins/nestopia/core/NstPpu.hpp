@@ -51,7 +51,7 @@ namespace Nes
 
 			void Reset(bool,bool);
 			void PowerOff();
-			void BeginFrame(bool);
+			void BeginFrame(bool,bool);
 			void EndFrame();
 
 			enum
@@ -166,6 +166,7 @@ namespace Nes
 			NES_DECL_POKE( 4014 );
 
 			NES_DECL_HOOK( Sync );
+			NES_DECL_HOOK( Poll );
 
 			NST_FORCE_INLINE Cycle GetCycles() const;
 			NST_FORCE_INLINE Cycle GetLocalCycles(Cycle) const;
@@ -204,6 +205,9 @@ namespace Nes
 			void Reset(bool,bool,bool);
 			void Update(Cycle,uint=0);
 			void UpdateStates();
+			void ScheduleSync();
+			Cycle GetSyncClock() const;
+			Cycle GetPollClock() const;
 			void UpdatePalette();
 			void LoadExtendedSprites();
 
@@ -211,9 +215,11 @@ namespace Nes
 			NST_FORCE_INLINE uint OpenSprite(const byte* NST_RESTRICT) const;
 			NST_FORCE_INLINE  void LoadSprite(uint,uint,const byte* NST_RESTRICT);
 			NST_SINGLE_CALL void PreLoadTiles();
-			NST_SINGLE_CALL void LoadTiles();
+			NST_FORCE_INLINE void LoadTiles();
+			NST_FORCE_INLINE void TestSpriteZero();
 			NST_FORCE_INLINE void RenderPixel();
 			NST_SINGLE_CALL void RenderPixel255();
+			void RenderScanline();
 			NST_NO_INLINE void Run();
 
 			struct Regs
@@ -379,6 +385,7 @@ namespace Nes
 				TileLut();
 
 				byte block[0x400][4];
+				byte row[2][0x100][8];
 			};
 
 			struct Io
@@ -422,9 +429,9 @@ namespace Nes
 			Oam oam;
 			Palette palette;
 			NameTable nameTable;
-			const TileLut tileLut;
 			Video::Screen screen;
 
+			static const TileLut tileLut;
 			static const byte yuvMaps[4][0x40];
 
 		public:
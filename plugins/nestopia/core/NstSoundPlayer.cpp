@@ -26,7 +26,7 @@
 #include "NstCpu.hpp"
 #include "NstChips.hpp"
 #include "NstSoundPlayer.hpp"
-#include "api/NstApiUser.hpp"
+#include "NstCallbacks.hpp"
 
 namespace Nes
 {
@@ -195,7 +195,7 @@ namespace Nes
 
 							try
 							{
-								Api::User::fileIoCallback( loader );
+								Callbacks::Current().user.fileIoCallback( loader );
 							}
 							catch (...)
 							{
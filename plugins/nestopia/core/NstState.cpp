@@ -23,7 +23,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////
 
 #include "NstState.hpp"
-#include "NstZlib.hpp"
+#include "NstLz.hpp"
 
 namespace Nes
 {
@@ -34,15 +34,16 @@ namespace Nes
 			enum Compression
 			{
 				NO_COMPRESSION,
-				ZLIB_COMPRESSION
+				ZLIB_COMPRESSION,
+				LZ_COMPRESSION
 			};
 
 			#ifdef NST_MSVC_OPTIMIZE
 			#pragma optimize("s", on)
 			#endif
 
-			Saver::Saver(StdStream p,bool c,bool i,dword append)
-			: stream(p), chunks(CHUNK_RESERVE), useCompression(c), internal(i)
+			Saver::Saver(StdStream p,Packing c,bool i,dword append)
+			: stream(p), chunks(CHUNK_RESERVE), packing(c), internal(i)
 			{
 				NST_COMPILE_ASSERT( CHUNK_RESERVE >= 2 );
 
@@ -57,6 +58,13 @@ namespace Nes
 				}
 			}
 
+			Saver::Saver(byte* data,dword size)
+			: stream(data,size), chunks(CHUNK_RESERVE), packing(Packing::STORE), internal(false)
+			{
+				chunks.SetTo(1);
+				chunks.Front() = 0;
+			}
+
 			Saver::~Saver()
 			{
 				NST_VERIFY( chunks.Size() == 1 );
@@ -128,14 +136,23 @@ namespace Nes
 			{
 				NST_VERIFY( length );
 
-				if (Zlib::AVAILABLE && useCompression && length > 1)
+				if (length > 1 && (packing.codec == Packing::LZ || (packing.codec == Packing::ZLIB && Zlib::AVAILABLE)))
 				{
 					Vector<byte> buffer( length - 1 );
 
-					if (const dword compressed = Zlib::Compress( data, length, buffer.Begin(), buffer.Size(), Zlib::BEST_COMPRESSION ))
+					const dword compressed = (packing.codec == Packing::LZ) ?
+					(
+						Lz::Compress( data, length, buffer.Begin(), buffer.Size() )
+					)
+					:
+					(
+						Zlib::Compress( data, length, buffer.Begin(), buffer.Size(), packing.level )
+					);
+
+					if (compressed)
 					{
 						chunks.Back() += 1 + compressed;
-						stream.Write8( ZLIB_COMPRESSION );
+						stream.Write8( packing.codec == Packing::LZ ? LZ_COMPRESSION : ZLIB_COMPRESSION );
 						stream.Write( buffer.Begin(), compressed );
 						return *this;
 					}
@@ -158,6 +175,12 @@ namespace Nes
 				chunks.SetTo(0);
 			}
 
+			Loader::Loader(const byte* data,dword size,bool c)
+			: stream(data,size), chunks(CHUNK_RESERVE), checkCrc(c)
+			{
+				chunks.SetTo(0);
+			}
+
 			Loader::~Loader()
 			{
 				NST_VERIFY( chunks.Size() <= 1 );
@@ -277,6 +300,19 @@ namespace Nes
 								break;
 						}
 
+						throw RESULT_ERR_CORRUPT_FILE;
+
+					case LZ_COMPRESSION:
+
+						if (chunks.Back())
+						{
+							Vector<byte> buffer( chunks.Back() );
+							Read( buffer.Begin(), buffer.Size() );
+
+							if (Lz::Uncompress( buffer.Begin(), buffer.Size(), data, length ) == length)
+								break;
+						}
+
 					default:
 
 						throw RESULT_ERR_CORRUPT_FILE;
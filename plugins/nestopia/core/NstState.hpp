@@ -30,6 +30,7 @@
 #endif
 
 #include "NstStream.hpp"
+#include "NstZlib.hpp"
 
 #ifdef NST_PRAGMA_ONCE
 #pragma once
@@ -41,11 +42,45 @@ namespace Nes
 	{
 		namespace State
 		{
+			/*
+			* How Saver::Compress packs large chunks. Loader reads every
+			* codec back, whichever one the saver used.
+			*/
+
+			struct Packing
+			{
+				enum Codec
+				{
+					STORE,
+					LZ,
+					ZLIB
+				};
+
+				Codec codec;
+				uint level;
+
+				explicit Packing(Codec c=STORE,uint l=Zlib::BEST_COMPRESSION)
+				: codec(c), level(l) {}
+
+				// smallest output, for states that end up on disk
+				static Packing Size()
+				{
+					return Packing( ZLIB, Zlib::BEST_COMPRESSION );
+				}
+
+				// cheap enough to run on the emulation thread
+				static Packing Speed()
+				{
+					return Packing( LZ );
+				}
+			};
+
 			class Saver
 			{
 			public:
 
-				Saver(StdStream,bool,bool,dword=0);
+				Saver(StdStream,Packing,bool,dword=0);
+				Saver(byte*,dword);
 				~Saver();
 
 				Saver& Begin(dword);
@@ -69,7 +104,7 @@ namespace Nes
 				};
 
 				Vector<dword> chunks;
-				const bool useCompression;
+				const Packing packing;
 				const bool internal;
 
 			public:
@@ -92,6 +127,11 @@ namespace Nes
 				{
 					return internal;
 				}
+
+				dword Written() const
+				{
+					return chunks.Front();
+				}
 			};
 
 			class Loader
@@ -99,6 +139,7 @@ namespace Nes
 			public:
 
 				Loader(StdStream,bool);
+				Loader(const byte*,dword,bool);
 				~Loader();
 
 				dword Begin();
@@ -22,6 +22,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////
 
+#include <cstring>
 #include <iostream>
 #include "NstVector.hpp"
 #include "NstStream.hpp"
@@ -34,6 +35,9 @@ namespace Nes
 		{
 			void In::Clear()
 			{
+				if (!stream)
+					return;
+
 				std::istream& ref = *static_cast<std::istream*>(stream);
 
 				if (!ref.bad())
@@ -42,13 +46,32 @@ namespace Nes
 
 			void In::SafeRead(byte* data,dword size)
 			{
-				static_cast<std::istream*>(stream)->read( reinterpret_cast<char*>(data), size );
+				if (stream)
+				{
+					static_cast<std::istream*>(stream)->read( reinterpret_cast<char*>(data), size );
+				}
+				else
+				{
+					size = NST_MIN(size,dword(end - pos));
+					std::memcpy( data, pos, size );
+					pos += size;
+				}
 			}
 
 			void In::Read(byte* data,dword size)
 			{
 				NST_ASSERT( data && size );
 
+				if (!stream)
+				{
+					if (size > dword(end - pos))
+						throw RESULT_ERR_CORRUPT_FILE;
+
+					std::memcpy( data, pos, size );
+					pos += size;
+					return;
+				}
+
 				SafeRead( data, size );
 
 				if (!*static_cast<std::istream*>(stream))
@@ -90,6 +113,9 @@ namespace Nes
 
 			uint In::SafeRead8()
 			{
+				if (!stream)
+					return pos != end ? *pos++ : ~0U;
+
 				byte data;
 				SafeRead( &data, 1 );
 				return *static_cast<std::istream*>(stream) ? data : ~0U;
@@ -101,6 +127,15 @@ namespace Nes
 
 			void In::Seek(idword distance)
 			{
+				if (!stream)
+				{
+					if (distance < begin - pos || distance > end - pos)
+						throw RESULT_ERR_CORRUPT_FILE;
+
+					pos += distance;
+					return;
+				}
+
 				Clear();
 
 				if (!static_cast<std::istream*>(stream)->seekg( distance, std::ios::cur ))
@@ -109,6 +144,9 @@ namespace Nes
 
 			ulong In::Length()
 			{
+				if (!stream)
+					return end - pos;
+
 				Clear();
 
 				std::istream& ref = *static_cast<std::istream*>(stream);
@@ -281,6 +319,9 @@ namespace Nes
 
 			bool In::Eof()
 			{
+				if (!stream)
+					return pos == end;
+
 				std::istream& ref = *static_cast<std::istream*>(stream);
 				return ref.eof() || (ref.peek(), ref.eof());
 			}
@@ -289,6 +330,18 @@ namespace Nes
 			{
 				NST_VERIFY( data && size );
 
+				if (!stream)
+				{
+					if (size > capacity - offset)
+						throw RESULT_ERR_OUT_OF_MEMORY;
+
+					if (memory)
+						std::memcpy( memory + offset, data, size );
+
+					offset += size;
+					return;
+				}
+
 				if (!static_cast<std::ostream*>(stream)->write( reinterpret_cast<const char*>(data), size ))
 					throw RESULT_ERR_CORRUPT_FILE;
 			}
@@ -352,6 +405,9 @@ namespace Nes
 
 			void Out::Clear()
 			{
+				if (!stream)
+					return;
+
 				std::ostream& ref = *static_cast<std::ostream*>(stream);
 
 				if (!ref.bad())
@@ -360,6 +416,15 @@ namespace Nes
 
 			void Out::Seek(idword distance)
 			{
+				if (!stream)
+				{
+					if (distance < 0 ? dword(-distance) > offset : dword(distance) > capacity - offset)
+						throw RESULT_ERR_CORRUPT_FILE;
+
+					offset += distance;
+					return;
+				}
+
 				Clear();
 
 				if (!static_cast<std::ostream*>(stream)->seekp( distance, std::ios::cur ))
@@ -368,6 +433,9 @@ namespace Nes
 
 			bool Out::SeekEnd()
 			{
+				if (!stream)
+					return false;
+
 				Clear();
 
 				std::ostream& ref = *static_cast<std::ostream*>(stream);
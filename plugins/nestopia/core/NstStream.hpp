@@ -44,9 +44,18 @@ namespace Nes
 
 		namespace Stream
 		{
+			/*
+			* Both directions either wrap a std stream or, when constructed
+			* from a memory range, read and write that range directly without
+			* touching iostreams or the heap.
+			*/
+
 			class In
 			{
 				StdStream const stream;
+				const byte* const begin;
+				const byte* pos;
+				const byte* const end;
 
 				void SafeRead(byte*,dword);
 				void Clear();
@@ -54,11 +63,17 @@ namespace Nes
 			public:
 
 				explicit In(StdStream s)
-				: stream(s)
+				: stream(s), begin(NULL), pos(NULL), end(NULL)
 				{
 					NST_ASSERT( stream );
 				}
 
+				In(const byte* data,dword size)
+				: stream(NULL), begin(data), pos(data), end(data + size)
+				{
+					NST_ASSERT( data || !size );
+				}
+
 				static dword AsciiToC(char* NST_RESTRICT,const byte* NST_RESTRICT,dword);
 
 				void  Read(byte*,dword);
@@ -98,17 +113,24 @@ namespace Nes
 			class Out
 			{
 				StdStream const stream;
+				byte* const memory;
+				dword offset;
+				const dword capacity;
 
 				void Clear();
 
 			public:
 
 				explicit Out(StdStream s)
-				: stream(s)
+				: stream(s), memory(NULL), offset(0), capacity(0)
 				{
 					NST_ASSERT( stream );
 				}
 
+				// a NULL range only counts the bytes that would be written
+				Out(byte* data,dword size)
+				: stream(NULL), memory(data), offset(0), capacity(data ? size : ~dword(0)) {}
+
 				void Write(const byte*,dword);
 				void Write8(uint);
 				void Write16(uint);
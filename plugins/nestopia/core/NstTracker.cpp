@@ -24,6 +24,7 @@
 
 #include <new>
 #include "NstMachine.hpp"
+#include "NstState.hpp"
 #include "NstTrackerMovie.hpp"
 #include "NstTrackerRewinder.hpp"
 #include "NstImage.hpp"
@@ -41,6 +42,7 @@ namespace Nes
 		:
 		frame           (0),
 		rewinderSound   (false),
+		rewinderMemory  (Rewinder::DEFAULT_MEMORY),
 		rewinderEnabled (NULL),
 		rewinder        (NULL),
 		movie           (NULL)
@@ -122,6 +124,14 @@ namespace Nes
 				rewinder->EnableSound( enable );
 		}
 
+		void Tracker::SetRewinderMemory(dword bytes)
+		{
+			rewinderMemory = bytes;
+
+			if (rewinder)
+				rewinder->SetMemory( bytes );
+		}
+
 		void Tracker::ResetRewinder() const
 		{
 			if (rewinder)
@@ -143,7 +153,8 @@ namespace Nes
 						rewinderEnabled->cpu,
 						rewinderEnabled->cpu.GetApu(),
 						rewinderEnabled->ppu,
-						rewinderSound
+						rewinderSound,
+						rewinderMemory
 					);
 				}
 			}
@@ -207,7 +218,7 @@ namespace Nes
 			return result;
 		}
 
-		Result Tracker::RecordMovie(Machine& emulator,std::iostream& stream,const bool append)
+		Result Tracker::RecordMovie(Machine& emulator,std::iostream& stream,const bool append,const State::Packing& packing)
 		{
 			if (!emulator.Is(Api::Machine::GAME))
 				return RESULT_ERR_NOT_READY;
@@ -230,7 +241,7 @@ namespace Nes
 					);
 				}
 
-				return movie->Record( stream, append ) ? RESULT_OK : RESULT_NOP;
+				return movie->Record( stream, append, packing ) ? RESULT_OK : RESULT_NOP;
 			}
 			catch (Result r)
 			{
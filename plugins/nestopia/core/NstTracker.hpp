@@ -50,6 +50,11 @@ namespace Nes
 			class Controllers;
 		}
 
+		namespace State
+		{
+			struct Packing;
+		}
+
 		class Tracker
 		{
 		public:
@@ -68,13 +73,14 @@ namespace Nes
 
 			Result EnableRewinder(Machine*);
 			void   EnableRewinderSound(bool);
+			void   SetRewinderMemory(dword);
 			void   ResetRewinder() const;
 			Result StartRewinding() const;
 			Result StopRewinding() const;
 			bool   IsRewinding() const;
 
 			Result PlayMovie(Machine&,std::istream&);
-			Result RecordMovie(Machine&,std::iostream&,bool);
+			Result RecordMovie(Machine&,std::iostream&,bool,const State::Packing&);
 			void   StopMovie();
 			bool   IsMoviePlaying() const;
 			bool   IsMovieRecording() const;
@@ -88,6 +94,7 @@ namespace Nes
 
 			dword frame;
 			ibool rewinderSound;
+			dword rewinderMemory;
 			Machine* rewinderEnabled;
 			Rewinder* rewinder;
 			Movie* movie;
@@ -104,6 +111,11 @@ namespace Nes
 				return rewinderSound;
 			}
 
+			dword GetRewinderMemory() const
+			{
+				return rewinderMemory;
+			}
+
 			bool IsFrameLocked() const
 			{
 				return movie;
@@ -28,8 +28,7 @@
 #include "NstState.hpp"
 #include "NstTrackerMovie.hpp"
 #include "NstZlib.hpp"
-#include "api/NstApiMovie.hpp"
-#include "api/NstApiUser.hpp"
+#include "NstCallbacks.hpp"
 
 namespace Nes
 {
@@ -227,7 +226,7 @@ namespace Nes
 			if (region != cpu.GetRegion())
 				throw RESULT_ERR_WRONG_MODE;
 
-			if (crc && prgCrc && crc != prgCrc && Api::User::questionCallback( Api::User::QUESTION_NSV_PRG_CRC_FAIL_CONTINUE ) == Api::User::ANSWER_NO)
+			if (crc && prgCrc && crc != prgCrc && Callbacks::Current().user.questionCallback( Api::User::QUESTION_NSV_PRG_CRC_FAIL_CONTINUE ) == Api::User::ANSWER_NO)
 				throw RESULT_ERR_INVALID_CRC;
 
 			return length;
@@ -291,8 +290,8 @@ namespace Nes
 
 			struct Saver : State::Saver
 			{
-				Saver(std::ostream& s,dword a)
-				: State::Saver(&s,true,true,a) {}
+				Saver(std::ostream& s,const State::Packing& p,dword a)
+				: State::Saver(&s,p,true,a) {}
 
 				bool operator == (std::ostream& s) const
 				{
@@ -312,8 +311,8 @@ namespace Nes
 
 		public:
 
-			Recorder(std::iostream& stream,Cpu& c,const dword prgCrc,const bool append)
-			: resync(true), frame(0), state(stream,append ? Player::Validate(stream,c,prgCrc) : 0), cpu(c)
+			Recorder(std::iostream& stream,Cpu& c,const dword prgCrc,const bool append,const State::Packing& packing)
+			: resync(true), frame(0), state(stream,packing,append ? Player::Validate(stream,c,prgCrc) : 0), cpu(c)
 			{
 				if (!append)
 				{
@@ -461,7 +460,7 @@ namespace Nes
 			Stop();
 		}
 
-		bool Tracker::Movie::Record(std::iostream& stream,const bool append)
+		bool Tracker::Movie::Record(std::iostream& stream,const bool append,const State::Packing& packing)
 		{
 			if (!Zlib::AVAILABLE)
 				throw RESULT_ERR_UNSUPPORTED;
@@ -474,9 +473,9 @@ namespace Nes
 
 			Stop();
 
-			recorder = new Recorder( stream, cpu, prgCrc, append );
+			recorder = new Recorder( stream, cpu, prgCrc, append, packing );
 
-			Api::Movie::eventCallback( Api::Movie::EVENT_RECORDING );
+			Callbacks::Current().movie.eventCallback( Api::Movie::EVENT_RECORDING );
 
 			return true;
 		}
@@ -496,7 +495,7 @@ namespace Nes
 
 			player = new Player( stream, cpu, prgCrc );
 
-			Api::Movie::eventCallback( Api::Movie::EVENT_PLAYING );
+			Callbacks::Current().movie.eventCallback( Api::Movie::EVENT_PLAYING );
 
 			return true;
 		}
@@ -538,14 +537,14 @@ namespace Nes
 					delete recorder;
 					recorder = NULL;
 
-					Api::Movie::eventCallback( Api::Movie::EVENT_RECORDING_STOPPED, result );
+					Callbacks::Current().movie.eventCallback( Api::Movie::EVENT_RECORDING_STOPPED, result );
 				}
 				else
 				{
 					delete player;
 					player = NULL;
 
-					Api::Movie::eventCallback( Api::Movie::EVENT_PLAYING_STOPPED, result );
+					Callbacks::Current().movie.eventCallback( Api::Movie::EVENT_PLAYING_STOPPED, result );
 
 					if (NES_FAILED(result))
 						return false;
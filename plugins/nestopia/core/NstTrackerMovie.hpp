@@ -44,7 +44,7 @@ namespace Nes
 			~Movie();
 
 			bool Play(std::istream&);
-			bool Record(std::iostream&,bool);
+			bool Record(std::iostream&,bool,const State::Packing&);
 			void Stop();
 			void Resync();
 			void Reset();
@@ -24,38 +24,26 @@
 
 #include <cstdlib>
 #include <cstring>
-#include <string>
 #include <algorithm>
 #include "NstMachine.hpp"
 #include "NstState.hpp"
 #include "NstTrackerRewinder.hpp"
-#include "api/NstApiRewinder.hpp"
-#include "NstZlib.hpp"
+#include "NstCallbacks.hpp"
+#include "NstLz.hpp"
 
 namespace Nes
 {
 	namespace Core
 	{
-		class Tracker::Rewinder::ReverseVideo::Mutex
-		{
-			Ppu& ppu;
-			Video::Screen::Pixel* const pixels;
-
-		public:
-
-			explicit Mutex(const ReverseVideo& r)
-			: ppu(r.ppu), pixels(r.ppu.GetOutputPixels()) {}
-
-			void Flush(Video::Screen::Pixel* src) const
-			{
-				std::memcpy( pixels, src, Video::Screen::PIXELS * sizeof(Video::Screen::Pixel) );
-			}
-
-			~Mutex()
-			{
-				ppu.SetOutputPixels( pixels );
-			}
-		};
+		/*
+		* Frames for backward playback, stored packed. Each is kept as the
+		* difference to the frame rendered right after it, which is the one
+		* shown right before it on the way back, so it unpacks on top of
+		* the screen. Rows equal to that frame are skipped, the others are
+		* runs of palette indices and of pixels left as they are, or stored
+		* as is if that is no smaller. The two newest frames are kept
+		* unpacked until the next one is rendered.
+		*/
 
 		class Tracker::Rewinder::ReverseVideo::Buffer
 		{
@@ -63,59 +51,56 @@ namespace Nes
 
 			enum
 			{
-				PIXELS    = Video::Screen::PIXELS,
-				SIZE      = PIXELS * dword(NUM_FRAMES),
-				FULL_SIZE = dword(SIZE) + Video::Screen::PIXELS_PADDING
+				WIDTH      = Video::Screen::WIDTH,
+				HEIGHT     = Video::Screen::HEIGHT,
+				PIXELS     = Video::Screen::PIXELS,
+				FULL_SIZE  = PIXELS + Video::Screen::PIXELS_PADDING,
+				MAX_PACKED = HEIGHT * (WIDTH + 1),
+				RUN_SHIFT  = 9,
+				RUN_MASK   = (1U << RUN_SHIFT) - 1,
+				MAX_RUN    = 0x8000 >> RUN_SHIFT,
+				SKIP       = 0x8000,
+				RAW        = 0xFFFF,
+				NO_FRAME   = NUM_FRAMES
 			};
 
-			Pixel pixels[FULL_SIZE];
+			NST_COMPILE_ASSERT( Video::Screen::PALETTE <= (1U << RUN_SHIFT) );
+
+			void Pack(uint,const Pixel*,const Pixel*);
+
+			uint last;
+			uint prev;
+			uint current;
+			Vector<Pixel> packed;
+			Vector<Pixel> frames[NUM_FRAMES];
+			Pixel pixels[2][FULL_SIZE];
 
 		public:
 
-			Buffer()
-			{
-				std::fill( pixels + SIZE, pixels + FULL_SIZE, Pixel(0) );
-			}
+			Buffer();
 
-			Pixel* operator [] (dword i)
-			{
-				NST_ASSERT( i < NUM_FRAMES );
-				return pixels + (PIXELS * i);
-			}
+			Pixel* Render(uint);
+			void Unpack(uint,Pixel*) const;
 		};
 
-		class Tracker::Rewinder::ReverseSound::Mutex
+		class Tracker::Rewinder::ReverseVideo::Mutex
 		{
-			Output::LockCallback funcLock;
-			void* userLock;
-			Output::UnlockCallback funcUnlock;
-			void* userUnlock;
+			Ppu& ppu;
+			Video::Screen::Pixel* const pixels;
 
 		public:
 
-			Mutex()
-			{
-				Output::lockCallback.Get( funcLock, userLock );
-				Output::unlockCallback.Get( funcUnlock, userUnlock );
-				Output::lockCallback.Set( NULL, NULL );
-				Output::unlockCallback.Set( NULL, NULL );
-			}
-
-			bool Lock(Output& output) const
-			{
-				return funcLock ? funcLock( userLock, output ) : true;
-			}
+			explicit Mutex(const ReverseVideo& r)
+			: ppu(r.ppu), pixels(r.ppu.GetOutputPixels()) {}
 
-			void Unlock(Output& output) const
+			void Flush(const Buffer& buffer,uint frame) const
 			{
-				if (funcUnlock)
-					funcUnlock( userUnlock, output );
+				buffer.Unpack( frame, pixels );
 			}
 
 			~Mutex()
 			{
-				Output::lockCallback.Set( funcLock, userLock );
-				Output::unlockCallback.Set( funcUnlock, userUnlock );
+				ppu.SetOutputPixels( pixels );
 			}
 		};
 
@@ -131,6 +116,17 @@ namespace Nes
 		buffer   (NULL)
 		{}
 
+		Tracker::Rewinder::ReverseVideo::Buffer::Buffer()
+		:
+		last    (NO_FRAME),
+		prev    (NO_FRAME),
+		current (0),
+		packed  (MAX_PACKED)
+		{
+			for (uint i=0; i < 2; ++i)
+				std::fill( pixels[i] + PIXELS, pixels[i] + FULL_SIZE, Pixel(0) );
+		}
+
 		Tracker::Rewinder::ReverseSound::ReverseSound(const Apu& a,bool e)
 		:
 		enabled (e),
@@ -145,9 +141,10 @@ namespace Nes
 		apu     (a)
 		{}
 
-		Tracker::Rewinder::Rewinder(Machine& e,EmuExecute x,EmuLoadState l,EmuSaveState s,Cpu& c,const Apu& a,Ppu& p,bool b)
+		Tracker::Rewinder::Rewinder(Machine& e,EmuExecute x,EmuLoadState l,EmuSaveState s,Cpu& c,const Apu& a,Ppu& p,bool b,dword m)
 		:
 		rewinding    (false),
+		memory       (m),
 		sound        (a,b),
 		video        (p),
 		emulator     (e),
@@ -190,24 +187,26 @@ namespace Nes
 			}
 		}
 
-		Tracker::Rewinder::Key::Key()
-		{
-		}
-
-		Tracker::Rewinder::Key::~Key()
+		void Tracker::Rewinder::Key::Reset()
 		{
+			offset = 0;
+			deltaSize = 0;
+			inputSize = 0;
+			inputLength = 0;
+			stateSize = 0;
+			serial = 0;
+			live = false;
 		}
 
-		void Tracker::Rewinder::Key::Input::Reset()
+		void Tracker::Rewinder::ClearKeys()
 		{
-			pos = BAD_POS;
-			buffer.Destroy();
-		}
+			for (uint i=0; i < NUM_KEYS; ++i)
+				keys[i].Reset();
 
-		void Tracker::Rewinder::Key::Reset()
-		{
-			stream.str( std::string() );
-			input.Reset();
+			recording = NULL;
+			oldest = NULL;
+			current = NULL;
+			head = 0;
 		}
 
 		void Tracker::Rewinder::Reset(bool on)
@@ -218,19 +217,113 @@ namespace Nes
 			if (rewinding)
 			{
 				rewinding = false;
-				Api::Rewinder::stateCallback( Api::Rewinder::STOPPED );
+				Callbacks::Current().rewinder.stateCallback( Api::Rewinder::STOPPED );
 			}
 
 			uturn = false;
 			frame = LAST_FRAME;
 			key = keys + LAST_KEY;
+			serial = 0;
+			playPos = BAD_POS;
+			recordGood = false;
 
-			for (uint i=0; i < NUM_FRAMES; ++i)
-				keys[i].Reset();
+			ClearKeys();
+
+			if (on)
+			{
+				state.Clear();
+				input.Clear();
+				playback.Clear();
+			}
+			else
+			{
+				arena.Destroy();
+				state.Destroy();
+				scratch.Destroy();
+				delta.Destroy();
+				input.Destroy();
+				playback.Destroy();
+			}
 
 			LinkPorts( on );
 		}
 
+		void Tracker::Rewinder::SetMemory(dword bytes)
+		{
+			if (memory != bytes)
+			{
+				memory = bytes;
+				arena.Destroy();
+				Reset( true );
+			}
+		}
+
+		dword Tracker::Rewinder::Allocate(dword size)
+		{
+			size = NST_MAX(size,1);
+
+			if (size > memory)
+				return BAD_POS;
+
+			if (arena.Size() != memory)
+			{
+				try
+				{
+					arena.Destroy();
+					arena.Resize( memory );
+				}
+				catch (...)
+				{
+					NST_DEBUG_MSG("Tracker::Rewinder::Allocate() failed!");
+					arena.Destroy();
+					return BAD_POS;
+				}
+			}
+
+			for (;;)
+			{
+				if (!oldest)
+					return 0;
+
+				const dword tail = oldest->offset;
+
+				if (head > tail)
+				{
+					if (memory - head >= size)
+						return head;
+
+					if (tail >= size)
+						return 0;
+				}
+				else if (tail - head >= size)
+				{
+					return head;
+				}
+
+				DropOldest();
+			}
+		}
+
+		void Tracker::Rewinder::DropOldest()
+		{
+			NST_ASSERT( oldest && oldest->live );
+
+			oldest->live = false;
+			oldest = NextKey( oldest );
+
+			if (!oldest->live)
+			{
+				oldest = NULL;
+				head = 0;
+			}
+		}
+
+		void Tracker::Rewinder::DropKey(Key* const k)
+		{
+			while (k->live)
+				DropOldest();
+		}
+
 		void Tracker::Rewinder::ReverseVideo::Begin()
 		{
 			pingpong = 1;
@@ -308,192 +401,338 @@ namespace Nes
 		#pragma optimize("", on)
 		#endif
 
-		inline void Tracker::Rewinder::Key::Input::Invalidate()
+		inline uint Tracker::Rewinder::Put(const uint data)
+		{
+			if (recordGood)
+			{
+				try
+				{
+					input.Append( data );
+				}
+				catch (...)
+				{
+					NST_DEBUG_MSG("input << data failed!");
+					recordGood = false;
+				}
+			}
+
+			return data;
+		}
+
+		inline uint Tracker::Rewinder::Get()
 		{
-			pos = BAD_POS;
+			if (playPos < playback.Size())
+			{
+				return playback[playPos++];
+			}
+			else
+			{
+				NST_DEBUG_MSG("playback >> data failed!");
+				playPos = BAD_POS;
+				return OPEN_BUS;
+			}
+		}
+
+		void Tracker::Rewinder::Pad(Vector<byte>& data,const dword size)
+		{
+			if (size > data.Size())
+			{
+				data.Reserve( size );
+				std::memset( data.Begin() + data.Size(), 0, size - data.Size() );
+			}
 		}
 
-		inline void Tracker::Rewinder::Key::Input::BeginForward()
+		byte* Tracker::Rewinder::PutVarint(byte* dst,dword value)
 		{
-			const dword hint = pos;
-			pos = 0;
-			buffer.Clear();
+			for (; value >= 0x80; value >>= 7)
+				*dst++ = (value & 0x7F) | 0x80;
+
+			*dst++ = value;
 
-			if (hint != BAD_POS)
-				buffer.Reserve( hint );
+			return dst;
 		}
 
-		bool Tracker::Rewinder::Key::Input::EndForward()
+		dword Tracker::Rewinder::GetVarint(const byte*& src,const byte* const end)
 		{
-			if (pos == 0)
+			dword value = 0;
+
+			for (uint shift=0; shift < 32; shift += 7)
 			{
-				pos = buffer.Size();
+				if (src == end)
+					break;
 
-				if (Zlib::AVAILABLE && pos >= MIN_COMPRESSION_SIZE)
-				{
-					Buffer tmp( pos - 1 );
+				const uint data = *src++;
+				value |= dword(data & 0x7F) << shift;
 
-					if (const dword size = Zlib::Compress( buffer.Begin(), buffer.Size(), tmp.Begin(), tmp.Size(), Zlib::NORMAL_COMPRESSION ))
-					{
-						NST_ASSERT( size < pos );
-						tmp.SetTo( size );
-						Buffer::Swap( tmp, buffer );
-					}
-					else
-					{
-						NST_DEBUG_MSG("compress() in Tracker::Rewinder::Key::Input failed!");
-					}
+				if (!(data & 0x80))
+					return value;
+			}
+
+			throw RESULT_ERR_CORRUPT_FILE;
+		}
+
+		void Tracker::Rewinder::EncodeDelta(Vector<byte>& out,Vector<byte>& a,Vector<byte>& b)
+		{
+			// Runs of a varint count of unchanged bytes to skip, a varint count
+			// of changed bytes and the changed bytes XOR'ed. The shorter state
+			// is compared as if padded with zeros. Lone unchanged bytes cost
+			// less inside a run than they would as a skip.
+
+			const dword size = NST_MAX(a.Size(),b.Size());
+
+			Pad( a, size );
+			Pad( b, size );
 
-					buffer.Defrag();
+			out.Clear();
+			out.Reserve( size * 2 + 16 );
+
+			const byte* const NST_RESTRICT x = a.Begin();
+			const byte* const NST_RESTRICT y = b.Begin();
+			byte* NST_RESTRICT dst = out.Begin();
+
+			for (dword i=0, skip=0; i < size; )
+			{
+				if (x[i] == y[i])
+				{
+					++i;
+					++skip;
+					continue;
 				}
 
-				return true;
+				const dword first = i;
+
+				while (++i < size && (x[i] != y[i] || (i+1 < size && x[i+1] != y[i+1])));
+
+				dst = PutVarint( dst, skip );
+				dst = PutVarint( dst, i - first );
+
+				for (dword j=first; j < i; ++j)
+					*dst++ = x[j] ^ y[j];
+
+				skip = 0;
 			}
 
-			return false;
+			out.SetTo( dst - out.Begin() );
 		}
 
-		void Tracker::Rewinder::Key::Input::BeginBackward()
+		void Tracker::Rewinder::DecodeDelta(Vector<byte>& data,const dword size,const byte* src,const dword length)
 		{
-			dword size = pos;
-			pos = 0;
+			const dword total = NST_MAX(data.Size(),size);
+
+			Pad( data, total );
 
-			if (Zlib::AVAILABLE && size > buffer.Size())
+			byte* const NST_RESTRICT dst = data.Begin();
+			const byte* const end = src + length;
+
+			for (dword i=0; src != end; )
 			{
-				Buffer tmp( size );
-				size = Zlib::Uncompress( buffer.Begin(), buffer.Size(), tmp.Begin(), tmp.Size() );
+				const dword skip = GetVarint( src, end );
+				dword count = GetVarint( src, end );
 
-				if (!size)
+				if (skip > total - i || count > total - i - skip || count > dword(end - src))
 					throw RESULT_ERR_CORRUPT_FILE;
 
-				NST_VERIFY( size == tmp.Size() );
-				Buffer::Swap( tmp, buffer );
+				for (i += skip; count--; )
+					dst[i++] ^= *src++;
 			}
-		}
 
-		inline void Tracker::Rewinder::Key::Input::EndBackward()
-		{
-			pos = 0;
+			data.SetTo( size );
 		}
 
-		inline void Tracker::Rewinder::Key::Input::ResumeForward()
+		const byte* Tracker::Rewinder::GetDelta(const Key* const k) const
 		{
-			NST_VERIFY( pos != BAD_POS );
-			dword size = pos;
-			pos = 0;
-			buffer.Resize( size != BAD_POS ? size : 0 );
-		}
+			if (k == recording)
+				return delta.Begin();
 
-		inline bool Tracker::Rewinder::Key::Input::CanRewind() const
-		{
-			return pos != BAD_POS;
+			if (!k->live)
+				throw RESULT_ERR_CORRUPT_FILE;
+
+			return arena.Begin() + k->offset;
 		}
 
-		inline uint Tracker::Rewinder::Key::Input::Put(const uint data)
+		void Tracker::Rewinder::SaveKey()
 		{
-			if (pos != BAD_POS)
+			DropKey( key );
+
+			if (current != PrevKey())
+			{
+				// nothing to make a delta against, start over
+
+				ClearKeys();
+				state.Clear();
+			}
+
+			if (!scratch.Capacity())
+			{
+				State::Saver saver( NULL, 0 );
+				(emulator.*emuSaveState)( saver );
+				scratch.Reserve( saver.Written() + SIZE_4K );
+			}
+
+			for (;;)
 			{
 				try
 				{
-					buffer.Append( data );
+					State::Saver saver( scratch.Begin(), scratch.Capacity() );
+					(emulator.*emuSaveState)( saver );
+					scratch.SetTo( saver.Written() );
+					break;
 				}
-				catch (...)
+				catch (Result result)
 				{
-					NST_DEBUG_MSG("buffer << data failed!");
-					pos = BAD_POS;
+					if (result != RESULT_ERR_OUT_OF_MEMORY)
+						throw;
 				}
+
+				scratch.Reserve( scratch.Capacity() * 2 );
 			}
 
-			return data;
+			EncodeDelta( delta, state, scratch );
+			Vector<byte>::Swap( state, scratch );
+
+			key->Reset();
+			key->deltaSize = delta.Size();
+			key->stateSize = state.Size();
+			key->serial = ++serial;
+
+			current = key;
+			recording = key;
+			recordGood = true;
+			input.Clear();
 		}
 
-		inline uint Tracker::Rewinder::Key::Input::Get()
+		void Tracker::Rewinder::CommitKey()
 		{
-			if (pos < buffer.Size())
+			if (recording != key)
+				return;
+
+			recording = NULL;
+
+			const dword offset = recordGood ? Allocate( key->deltaSize + input.Size() ) : dword(BAD_POS);
+
+			if (offset == BAD_POS)
 			{
-				return buffer[pos++];
+				// keys before this one can't be reached anymore
+
+				ClearKeys();
+				return;
 			}
-			else
+
+			byte* const record = arena.Begin() + offset;
+			std::memcpy( record, delta.Begin(), key->deltaSize );
+
+			key->offset = offset;
+			key->inputSize = key->inputLength = input.Size();
+
+			if (input.Size() >= MIN_COMPRESSION_SIZE)
 			{
-				NST_DEBUG_MSG("buffer >> data failed!");
-				pos = BAD_POS;
-				return OPEN_BUS;
+				if (const dword size = Lz::Compress( input.Begin(), input.Size(), record + key->deltaSize, input.Size() - 1 ))
+					key->inputSize = size;
+				else
+					NST_DEBUG_MSG("Lz::Compress() in Tracker::Rewinder::CommitKey() failed!");
 			}
-		}
 
-		inline void Tracker::Rewinder::Key::Invalidate()
-		{
-			input.Invalidate();
-		}
+			if (key->inputSize == key->inputLength && input.Size())
+				std::memcpy( record + key->deltaSize, input.Begin(), input.Size() );
 
-		inline bool Tracker::Rewinder::Key::CanRewind() const
-		{
-			return input.CanRewind();
+			head = offset + NST_MAX(key->deltaSize + key->inputSize,1);
+			key->live = true;
+
+			if (!oldest)
+				oldest = key;
 		}
 
-		inline void Tracker::Rewinder::Key::ResumeForward()
+		void Tracker::Rewinder::LoadKey(Key* const k)
 		{
-			input.ResumeForward();
+			if (!current)
+				throw RESULT_ERR_CORRUPT_FILE;
+
+			while (current != k)
+			{
+				if (k->serial < current->serial)
+				{
+					Key* const prev = PrevKey( current );
+
+					if (prev->serial + 1 != current->serial || (!prev->live && prev != recording))
+						throw RESULT_ERR_CORRUPT_FILE;
+
+					DecodeDelta( state, prev->stateSize, GetDelta( current ), current->deltaSize );
+					current = prev;
+				}
+				else
+				{
+					Key* const next = NextKey( current );
+
+					if (current->serial + 1 != next->serial)
+						throw RESULT_ERR_CORRUPT_FILE;
+
+					DecodeDelta( state, next->stateSize, GetDelta( next ), next->deltaSize );
+					current = next;
+				}
+			}
+
+			State::Loader loader( state.Begin(), state.Size(), false );
+			(emulator.*emuLoadState)( loader, true );
 		}
 
-		void Tracker::Rewinder::Key::BeginForward(Machine& emulator,EmuSaveState saveState,EmuLoadState loadState)
+		void Tracker::Rewinder::PlayKey(Key* const k)
 		{
-			NST_ASSERT( !saveState || !loadState );
+			if (!k->live)
+				throw RESULT_ERR_CORRUPT_FILE;
 
-			input.BeginForward();
+			LoadKey( k );
 
-			if (saveState)
-			{
-				stream.clear();
-				stream.seekp( 0, std::stringstream::beg );
-				stream.clear();
+			playback.Resize( k->inputLength );
+			playPos = 0;
 
-				State::Saver saver( &static_cast<std::ostream&>(stream), false, true );
-				(emulator.*saveState)( saver );
-			}
-			else if (loadState)
+			if (k->inputLength)
 			{
-				TurnForward( emulator, loadState );
+				const byte* const src = arena.Begin() + k->offset + k->deltaSize;
+
+				if (k->inputSize == k->inputLength)
+					std::memcpy( playback.Begin(), src, k->inputLength );
+				else if (Lz::Uncompress( src, k->inputSize, playback.Begin(), k->inputLength ) != k->inputLength)
+					throw RESULT_ERR_CORRUPT_FILE;
 			}
 		}
 
-		void Tracker::Rewinder::Key::EndForward()
+		void Tracker::Rewinder::ResumeKey(Key* const k,const bool keepInput)
 		{
-			if (!input.EndForward())
-				Reset();
-		}
+			NST_ASSERT( current == k );
 
-		void Tracker::Rewinder::Key::TurnForward(Machine& emulator,EmuLoadState loadState)
-		{
-			stream.clear();
-			stream.seekg( 0, std::stringstream::beg );
-			stream.clear();
+			if (!k->live)
+				throw RESULT_ERR_CORRUPT_FILE;
 
-			State::Loader loader( &static_cast<std::istream&>(stream), false );
-			(emulator.*loadState)( loader, true );
-		}
+			// take the key and everything after it back out of the arena
 
-		void Tracker::Rewinder::Key::BeginBackward(Machine& emulator,EmuLoadState loadState)
-		{
-			NST_VERIFY( CanRewind() );
+			delta.Assign( arena.Begin() + k->offset, k->deltaSize );
 
-			TurnForward( emulator, loadState );
-			input.BeginBackward();
-		}
+			if (oldest == k)
+			{
+				oldest = NULL;
+				head = 0;
+			}
+			else
+			{
+				head = k->offset;
+			}
 
-		inline void Tracker::Rewinder::Key::EndBackward()
-		{
-			input.EndBackward();
-		}
+			for (Key* it=k; it->live; it=NextKey(it))
+				it->live = false;
 
-		inline uint Tracker::Rewinder::Key::Put(uint data)
-		{
-			return input.Put( data );
-		}
+			recording = k;
+			recordGood = true;
+			input.Clear();
 
-		inline uint Tracker::Rewinder::Key::Get()
-		{
-			return input.Get();
+			if (keepInput)
+			{
+				NST_VERIFY( playPos != BAD_POS );
+
+				if (playPos != BAD_POS)
+					input.Assign( playback.Begin(), playPos );
+				else
+					recordGood = false;
+			}
 		}
 
 		inline Tracker::Rewinder::Key* Tracker::Rewinder::PrevKey(Key* k)
@@ -516,16 +755,139 @@ namespace Nes
 			return NextKey( key );
 		}
 
+		void Tracker::Rewinder::ReverseVideo::Buffer::Pack(const uint frame,const Pixel* NST_RESTRICT src,const Pixel* NST_RESTRICT ref)
+		{
+			Pixel* NST_RESTRICT dst = packed.Begin();
+
+			for (uint y=0; y < HEIGHT; ++y, src += WIDTH, ref += WIDTH)
+			{
+				Pixel* const runs = dst++;
+
+				if (std::memcmp( src, ref, WIDTH * sizeof(Pixel) ) == 0)
+				{
+					*runs = 0;
+					continue;
+				}
+
+				for (uint x=0; x < WIDTH; )
+				{
+					uint length = 1;
+
+					if (src[x] == ref[x])
+					{
+						while (x + length < WIDTH && src[x + length] == ref[x + length])
+							++length;
+
+						*dst++ = SKIP | (length - 1);
+					}
+					else
+					{
+						while (x + length < WIDTH && length < MAX_RUN && src[x + length] == src[x])
+							++length;
+
+						*dst++ = (length - 1) << RUN_SHIFT | src[x];
+					}
+
+					x += length;
+				}
+
+				if (dst - (runs + 1) < WIDTH)
+				{
+					*runs = dst - (runs + 1);
+				}
+				else
+				{
+					*runs = RAW;
+					std::memcpy( runs + 1, src, WIDTH * sizeof(Pixel) );
+					dst = runs + 1 + WIDTH;
+				}
+			}
+
+			NST_ASSERT( dword(dst - packed.Begin()) <= MAX_PACKED );
+			frames[frame].Assign( packed.Begin(), dst - packed.Begin() );
+		}
+
+		Video::Screen::Pixel* Tracker::Rewinder::ReverseVideo::Buffer::Render(const uint frame)
+		{
+			NST_ASSERT( frame < NUM_FRAMES );
+
+			if (last != NO_FRAME)
+			{
+				if (prev != NO_FRAME)
+					Pack( prev, pixels[current ^ 1U], pixels[current] );
+
+				if (frame != last)
+				{
+					prev = last;
+					current ^= 1U;
+				}
+				else
+				{
+					prev = NO_FRAME;
+				}
+			}
+
+			last = frame;
+
+			return pixels[current];
+		}
+
+		void Tracker::Rewinder::ReverseVideo::Buffer::Unpack(const uint frame,Pixel* NST_RESTRICT dst) const
+		{
+			NST_ASSERT( frame < NUM_FRAMES );
+
+			if (frame == last)
+			{
+				std::memcpy( dst, pixels[current], PIXELS * sizeof(Pixel) );
+			}
+			else if (frame == prev)
+			{
+				std::memcpy( dst, pixels[current ^ 1U], PIXELS * sizeof(Pixel) );
+			}
+			else
+			{
+				const Pixel* NST_RESTRICT src = frames[frame].Begin();
+				const Pixel* const end = frames[frame].End();
+
+				for (; src != end; dst += WIDTH)
+				{
+					Pixel* NST_RESTRICT pixel = dst;
+
+					if (*src == RAW)
+					{
+						std::memcpy( dst, src + 1, WIDTH * sizeof(Pixel) );
+						src += 1 + WIDTH;
+						continue;
+					}
+
+					for (uint runs = *src++; runs; --runs)
+					{
+						const uint run = *src++;
+
+						if (run & SKIP)
+						{
+							pixel += (run & ~uint(SKIP)) + 1;
+						}
+						else
+						{
+							for (Pixel* const stop = pixel + (run >> RUN_SHIFT) + 1; pixel != stop; )
+								*pixel++ = run & RUN_MASK;
+						}
+					}
+				}
+			}
+		}
+
 		inline void Tracker::Rewinder::ReverseVideo::Flush(const Mutex& mutex)
 		{
-			mutex.Flush( (*buffer)[frame] );
+			mutex.Flush( *buffer, frame );
 		}
 
 		void Tracker::Rewinder::ReverseVideo::Store()
 		{
 			NST_ASSERT( frame < NUM_FRAMES && (pingpong == 1U-0U || pingpong == 0U-1U) );
 
-			ppu.SetOutputPixels( (*buffer)[frame] );
+			ppu.SetOutputPixels( buffer->Render( frame ) );
 			frame += pingpong;
 
 			if (frame == NUM_FRAMES)
@@ -626,9 +988,9 @@ namespace Nes
 			return src;
 		}
 
-		void Tracker::Rewinder::ReverseSound::Flush(Output* const target,const Mutex& mutex)
+		void Tracker::Rewinder::ReverseSound::Flush(Output* const target)
 		{
-			if (target && mutex.Lock( *target ))
+			if (target && target->lockCallback( *target ))
 			{
 				if (enabled & good)
 				{
@@ -642,7 +1004,7 @@ namespace Nes
 						ReverseSilence<byte,0x80>( *target );
 				}
 
-				mutex.Unlock( *target );
+				target->unlockCallback( *target );
 			}
 		}
 
@@ -660,9 +1022,9 @@ namespace Nes
 					if (++frame == NUM_FRAMES)
 					{
 						frame = 0;
-						key->EndForward();
+						CommitKey();
 						key = NextKey();
-						key->BeginForward( emulator, emuSaveState, NULL );
+						SaveKey();
 					}
 				}
 				else
@@ -670,24 +1032,24 @@ namespace Nes
 					if (++frame == NUM_FRAMES)
 					{
 						frame = 0;
-						key->EndBackward();
 
 						Key* const prev = PrevKey();
 
-						if (prev->CanRewind())
+						if (prev->live)
 						{
-							prev->BeginBackward( emulator, emuLoadState );
+							PlayKey( prev );
 							key = prev;
 						}
 						else
 						{
 							rewinding = false;
 
-							key->Invalidate();
+							DropKey( key );
 							key = NextKey();
-							key->BeginForward( emulator, NULL, emuLoadState );
+							LoadKey( key );
+							ResumeKey( key, false );
 
-							Api::Rewinder::stateCallback( Api::Rewinder::STOPPED );
+							Callbacks::Current().rewinder.stateCallback( Api::Rewinder::STOPPED );
 
 							LinkPorts();
 						}
@@ -699,8 +1061,7 @@ namespace Nes
 						video.Flush( videoMutex );
 						video.Store();
 
-						const ReverseSound::Mutex soundMutex;
-						sound.Flush( soundOut, soundMutex );
+						sound.Flush( soundOut );
 						soundOut = sound.Store();
 
 						(emulator.*emuExecute)( videoOut, soundOut, inputOut );
@@ -719,7 +1080,7 @@ namespace Nes
 
 		void Tracker::Rewinder::ChangeDirection()
 		{
-			Api::Rewinder::stateCallback( Api::Rewinder::PREPARING );
+			Callbacks::Current().rewinder.stateCallback( Api::Rewinder::PREPARING );
 
 			uturn = false;
 
@@ -728,17 +1089,20 @@ namespace Nes
 				for (uint i=frame; i < LAST_FRAME; ++i)
 					(emulator.*emuExecute)( NULL, NULL, NULL );
 
-				NextKey()->Invalidate();
+				DropKey( NextKey() );
+				CommitKey();
+
+				if (!key->live)
+					throw RESULT_ERR_OUT_OF_MEMORY;
 
 				video.Begin();
 				sound.Begin();
 
-				key->BeginBackward( emulator, emuLoadState );
+				PlayKey( key );
 				LinkPorts();
 
 				{
 					const ReverseVideo::Mutex videoMutex( video );
-					const ReverseSound::Mutex soundMutex;
 
 					for (uint i=0; i < NUM_FRAMES; ++i)
 					{
@@ -758,7 +1122,7 @@ namespace Nes
 						throw RESULT_ERR_CORRUPT_FILE;
 				}
 
-				Api::Rewinder::stateCallback( Api::Rewinder::REWINDING );
+				Callbacks::Current().rewinder.stateCallback( Api::Rewinder::REWINDING );
 			}
 			else
 			{
@@ -768,20 +1132,20 @@ namespace Nes
 					{
 						frame = 0;
 						key = NextKey();
-						key->TurnForward( emulator, emuLoadState );
+						PlayKey( key );
 					}
 
 					(emulator.*emuExecute)( NULL, NULL, NULL );
 				}
 
-				key->ResumeForward();
+				ResumeKey( key, true );
 
 				LinkPorts();
 
 				video.End();
 				sound.End();
 
-				Api::Rewinder::stateCallback( Api::Rewinder::STOPPED );
+				Callbacks::Current().rewinder.stateCallback( Api::Rewinder::STOPPED );
 			}
 		}
 
@@ -790,7 +1154,7 @@ namespace Nes
 			if (rewinding)
 				return RESULT_NOP;
 
-			if (uturn || !PrevKey()->CanRewind())
+			if (uturn || !PrevKey()->live)
 				return RESULT_ERR_NOT_READY;
 
 			uturn = true;
@@ -815,12 +1179,12 @@ namespace Nes
 
 		NES_PEEK_A(Tracker::Rewinder,Port_Put)
 		{
-			return key->Put( ports[address-0x4016]->Peek( address ) );
+			return Put( ports[address-0x4016]->Peek( address ) );
 		}
 
 		NES_PEEK(Tracker::Rewinder,Port_Get)
 		{
-			return key->Get();
+			return Get();
 		}
 
 		NES_POKE_AD(Tracker::Rewinder,Port)
@@ -25,7 +25,6 @@
 #ifndef NST_TRACKER_REWINDER_H
 #define NST_TRACKER_REWINDER_H
 
-#include <sstream>
 #include "api/NstApiSound.hpp"
 
 #ifndef NST_VECTOR_H
@@ -48,12 +47,18 @@ namespace Nes
 
 		public:
 
-			Rewinder(Machine&,EmuExecute,EmuLoadState,EmuSaveState,Cpu&,const Apu&,Ppu&,bool);
+			Rewinder(Machine&,EmuExecute,EmuLoadState,EmuSaveState,Cpu&,const Apu&,Ppu&,bool,dword);
 			~Rewinder();
 
+			enum
+			{
+				DEFAULT_MEMORY = SIZE_4096K
+			};
+
 			Result Start();
 			Result Stop();
 			void   Execute(Video::Output*,Sound::Output*,Input::Controllers*);
+			void   SetMemory(dword);
 
 		private:
 
@@ -63,67 +68,59 @@ namespace Nes
 
 			enum
 			{
-				NUM_KEYS = 60,
+				NUM_KEYS = 3600,
 				LAST_KEY = NUM_KEYS-1,
 				NUM_FRAMES = 60,
-				LAST_FRAME = NUM_FRAMES-1
+				LAST_FRAME = NUM_FRAMES-1,
+				BAD_POS = INT_MAX,
+				MIN_COMPRESSION_SIZE = 1024,
+				OPEN_BUS = 0x40
 			};
 
-			class Key
+			/*
+			* One key spans NUM_FRAMES frames. A completed key is a single
+			* record in the arena, a ring of preallocated memory: the state
+			* at its first frame as an XOR/RLE delta against the state of
+			* the previous key, followed by the controller reads during its
+			* frames. XOR deltas go both ways, so one full state is enough
+			* to walk to any live key. The oldest records are dropped when
+			* the arena runs out of room, so the depth of the history is
+			* set by its memory budget rather than a number of keys.
+			*/
+
+			struct Key
 			{
-				class Input
-				{
-					typedef Vector<byte> Buffer;
-
-					enum
-					{
-						BAD_POS = INT_MAX,
-						MIN_COMPRESSION_SIZE = 1024,
-						OPEN_BUS = 0x40
-					};
-
-					dword pos;
-					Buffer buffer;
-
-				public:
-
-					void Reset();
-					inline void BeginForward();
-					bool EndForward();
-					void BeginBackward();
-					inline void EndBackward();
-
-					inline uint Put(uint);
-					inline uint Get();
-
-					inline void ResumeForward();
-					inline bool CanRewind() const;
-					inline void Invalidate();
-				};
-
-				Input input;
-				std::stringstream stream;
-
-			public:
-
-				Key();
-				~Key();
-
 				void Reset();
-				void BeginForward(Machine&,EmuSaveState,EmuLoadState);
-				void EndForward();
-				void BeginBackward(Machine&,EmuLoadState);
-				inline void EndBackward();
-
-				inline uint Put(uint);
-				inline uint Get();
-
-				inline bool CanRewind() const;
-				inline void ResumeForward();
-				inline void TurnForward(Machine&,EmuLoadState);
-				inline void Invalidate();
+
+				dword offset;
+				dword deltaSize;
+				dword inputSize;
+				dword inputLength;
+				dword stateSize;
+				dword serial;
+				ibool live;
 			};
 
+			void SaveKey();
+			void CommitKey();
+			void LoadKey(Key*);
+			void PlayKey(Key*);
+			void ResumeKey(Key*,bool);
+			void DropKey(Key*);
+			void ClearKeys();
+			void DropOldest();
+			dword Allocate(dword);
+			const byte* GetDelta(const Key*) const;
+
+			inline uint Put(uint);
+			inline uint Get();
+
+			static void Pad(Vector<byte>&,dword);
+			static byte* PutVarint(byte*,dword);
+			static dword GetVarint(const byte*&,const byte*);
+			static void EncodeDelta(Vector<byte>&,Vector<byte>&,Vector<byte>&);
+			static void DecodeDelta(Vector<byte>&,dword,const byte*,dword);
+
 			class ReverseVideo
 			{
 			public:
@@ -157,13 +154,11 @@ namespace Nes
 				ReverseSound(const Apu&,bool);
 				~ReverseSound();
 
-				class Mutex;
-
 				void    Begin();
 				void    End();
 				void    Enable(bool);
 				Output* Store();
-				void    Flush(Output*,const Mutex&);
+				void    Flush(Output*);
 
 			private:
 
@@ -214,6 +209,22 @@ namespace Nes
 			const Io::Port* ports[2];
 
 			Key* key;
+			Key* recording;
+			Key* oldest;
+			Key* current;
+			dword serial;
+			dword head;
+			dword memory;
+			dword playPos;
+			ibool recordGood;
+
+			Vector<byte> arena;
+			Vector<byte> state;
+			Vector<byte> scratch;
+			Vector<byte> delta;
+			Vector<byte> input;
+			Vector<byte> playback;
+
 			Key keys[NUM_KEYS];
 
 			ReverseSound sound;
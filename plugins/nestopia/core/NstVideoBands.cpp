@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "NstCore.hpp"
+#include "NstVideoBands.hpp"
+
+namespace Nes
+{
+	namespace Core
+	{
+		namespace Video
+		{
+			struct Bands::Job
+			{
+				Routine routine;
+				const void* context;
+				uint rows;
+				uint count;
+				uint next;
+				uint pending;
+				Job* link;
+			};
+
+			class Bands::Pool
+			{
+			public:
+
+				Pool();
+				~Pool();
+
+				void Run(Job&);
+
+				uint Count() const
+				{
+					return count;
+				}
+
+			private:
+
+				void Work();
+				void Remove(const Job&);
+
+				std::mutex mutex;
+				std::condition_variable start;
+				std::condition_variable finish;
+				Job* jobs;
+				bool stop;
+				uint count;
+				std::thread threads[MAX_BANDS-1];
+			};
+
+			#ifdef NST_MSVC_OPTIMIZE
+			#pragma optimize("s", on)
+			#endif
+
+			Bands::Pool::Pool()
+			:
+			jobs  (NULL),
+			stop  (false),
+			count (1)
+			{
+				uint target = std::thread::hardware_concurrency();
+
+				if (target > MAX_BANDS)
+					target = MAX_BANDS;
+
+				// fewer bands is fine if the system won't give us the threads
+
+				try
+				{
+					while (count < target)
+					{
+						threads[count-1] = std::thread( &Pool::Work, this );
+						count++;
+					}
+				}
+				catch (...)
+				{
+				}
+			}
+
+			Bands::Pool::~Pool()
+			{
+				{
+					std::lock_guard<std::mutex> lock( mutex );
+					stop = true;
+				}
+
+				start.notify_all();
+
+				for (uint i=0; i < count-1; ++i)
+					threads[i].join();
+			}
+
+			#ifdef NST_MSVC_OPTIMIZE
+			#pragma optimize("", on)
+			#endif
+
+			void Bands::Run(Routine routine,const void* context,uint rows)
+			{
+				static Pool pool;
+
+				if (pool.Count() < 2)
+				{
+					routine( context, 0, rows );
+				}
+				else
+				{
+					Job job = { routine, context, rows, pool.Count(), 0, pool.Count(), NULL };
+					pool.Run( job );
+				}
+			}
+
+			void Bands::Pool::Remove(const Job& job)
+			{
+				for (Job** it = &jobs; *it; it = &(*it)->link)
+				{
+					if (*it == &job)
+					{
+						*it = job.link;
+						break;
+					}
+				}
+			}
+
+			void Bands::Pool::Run(Job& job)
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+
+				{
+					Job** it = &jobs;
+
+					while (*it)
+						it = &(*it)->link;
+
+					*it = &job;
+				}
+
+				start.notify_all();
+
+				// take bands off our own job until none are left, then wait
+				// for the ones the workers picked up
+
+				for (;;)
+				{
+					if (job.next < job.count)
+					{
+						const uint band = job.next++;
+
+						if (job.next == job.count)
+							Remove( job );
+
+						lock.unlock();
+
+						job.routine( job.context, job.rows * band / job.count, job.rows * (band+1) / job.count );
+
+						lock.lock();
+
+						--job.pending;
+					}
+					else if (job.pending)
+					{
+						finish.wait( lock );
+					}
+					else
+					{
+						break;
+					}
+				}
+			}
+
+			void Bands::Pool::Work()
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+
+				for (;;)
+				{
+					while (!stop && !jobs)
+						start.wait( lock );
+
+					if (stop)
+						break;
+
+					Job& job = *jobs;
+					const uint band = job.next++;
+
+					if (job.next == job.count)
+						jobs = job.link;
+
+					lock.unlock();
+
+					job.routine( job.context, job.rows * band / job.count, job.rows * (band+1) / job.count );
+
+					lock.lock();
+
+					if (!--job.pending)
+						finish.notify_all();
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////////////
+//
+// Nestopia - NES/Famicom emulator written in C++
+//
+// Copyright (C) 2003-2008 Martin Freij
+//
+// This file is part of Nestopia.
+//
+// Nestopia is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Nestopia is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Nestopia; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NST_VIDEO_BANDS_H
+#define NST_VIDEO_BANDS_H
+
+#ifdef NST_PRAGMA_ONCE
+#pragma once
+#endif
+
+namespace Nes
+{
+	namespace Core
+	{
+		namespace Video
+		{
+			/*
+			* Splits a filter pass into horizontal bands of rows and runs them
+			* on a few worker threads, the calling thread taking the first band.
+			* Run() returns once every band is done. The workers belong to one
+			* pool shared by every filter in the process, started on the first
+			* pass. Bands no worker got to are run by the caller, so passes from
+			* several emulators at once don't wait on each other. With no spare
+			* hardware threads the whole pass simply runs inline.
+			*/
+
+			class Bands
+			{
+			public:
+
+				typedef void (*Routine)(const void*,uint,uint);
+
+				static void Run(Routine,const void*,uint);
+
+			private:
+
+				enum
+				{
+					MAX_BANDS = 4
+				};
+
+				struct Job;
+				class Pool;
+			};
+		}
+	}
+}
+
+#endif
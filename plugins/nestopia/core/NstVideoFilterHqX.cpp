@@ -31,6 +31,10 @@
 #include "NstVideoRenderer.hpp"
 #include "NstVideoFilterHqX.hpp"
 
+#ifdef NST_MM_INTRINSICS
+#include <emmintrin.h>
+#endif
+
 namespace Nes
 {
 	namespace Core
@@ -39,7 +43,14 @@ namespace Nes
 		{
 			void Renderer::FilterHqX::Blit(const Input& input,const Output& output,uint)
 			{
-				(*this.*path)( input, output );
+				const Job job = { *this, input, output };
+				Bands::Run( &FilterHqX::BlitBand, &job, HEIGHT );
+			}
+
+			void Renderer::FilterHqX::BlitBand(const void* const data,const uint first,const uint last)
+			{
+				const Job& job = *static_cast<const Job*>(data);
+				(job.filter.*job.filter.path)( job.input, job.output, first, last );
 			}
 
 			template<dword R,dword G,dword B>
@@ -125,6 +136,203 @@ namespace Nes
 				return (lut.yuv[w1] - lut.yuv[w2] + Lut::YUV_OFFSET) & Lut::YUV_MASK;
 			}
 
+			#ifndef NST_MM_INTRINSICS
+
+			// one pixel's neighbor pattern, for the per-pixel loop used without SSE2
+
+			inline uint Renderer::FilterHqX::GetPattern(const uint (&w)[10]) const
+			{
+				const dword yuv5 = lut.yuv[w[4]];
+
+				return
+				(
+					(w[4] != w[0] && ((yuv5 - lut.yuv[w[0]]) & Lut::YUV_MASK) ? 0x01U : 0x0U) |
+					(w[4] != w[1] && ((yuv5 - lut.yuv[w[1]]) & Lut::YUV_MASK) ? 0x02U : 0x0U) |
+					(w[4] != w[2] && ((yuv5 - lut.yuv[w[2]]) & Lut::YUV_MASK) ? 0x04U : 0x0U) |
+					(w[4] != w[3] && ((yuv5 - lut.yuv[w[3]]) & Lut::YUV_MASK) ? 0x08U : 0x0U) |
+					(w[4] != w[5] && ((yuv5 - lut.yuv[w[5]]) & Lut::YUV_MASK) ? 0x10U : 0x0U) |
+					(w[4] != w[6] && ((yuv5 - lut.yuv[w[6]]) & Lut::YUV_MASK) ? 0x20U : 0x0U) |
+					(w[4] != w[7] && ((yuv5 - lut.yuv[w[7]]) & Lut::YUV_MASK) ? 0x40U : 0x0U) |
+					(w[4] != w[8] && ((yuv5 - lut.yuv[w[8]]) & Lut::YUV_MASK) ? 0x80U : 0x0U)
+				);
+			}
+
+			#endif
+
+			#ifdef NST_MM_INTRINSICS
+
+			struct Renderer::FilterHqX::Rows
+			{
+				// Palette colors and YUV of the rows above, at and below the one being
+				// filtered, with the edge pixels repeated so that every pixel's
+				// neighbors sit at fixed offsets. Moving down a row loads only one row.
+
+				Rows(const Input&,const Lut&,uint);
+
+				void Next(const Input&,const Lut&);
+
+				NST_FORCE_INLINE void Fetch(uint (&w)[10],const uint x) const
+				{
+					w[0] = colors[0][x+0];
+					w[1] = colors[0][x+1];
+					w[2] = colors[0][x+2];
+					w[3] = colors[1][x+0];
+					w[4] = colors[1][x+1];
+					w[5] = colors[1][x+2];
+					w[6] = colors[2][x+0];
+					w[7] = colors[2][x+1];
+					w[8] = colors[2][x+2];
+				}
+
+				// bit n of a pattern is set when the nth neighbor differs visibly from the center pixel
+
+				NST_FORCE_INLINE uint GetPattern(const uint x) const
+				{
+					return patterns[x];
+				}
+
+			private:
+
+				void Load(uint,const Input&,const Lut&,uint);
+				void Rotate();
+
+				uint y;
+				uint top;
+				const uint* colors[3];
+				const dword* yuv[3];
+				uint colorRows[3][1+WIDTH+1];
+				dword yuvRows[3][1+WIDTH+1];
+				byte patterns[WIDTH];
+
+				void UpdatePatterns();
+			};
+
+			Renderer::FilterHqX::Rows::Rows(const Input& input,const Lut& lut,const uint row)
+			: y(row), top(0)
+			{
+				Load( 0, input, lut, y > 0 ? y-1 : y );
+				Load( 1, input, lut, y );
+				Load( 2, input, lut, y < HEIGHT-1 ? y+1 : y );
+				Rotate();
+			}
+
+			void Renderer::FilterHqX::Rows::Next(const Input& input,const Lut& lut)
+			{
+				++y;
+				Load( top, input, lut, y < HEIGHT-1 ? y+1 : y );
+				top = (top + 1) % 3;
+				Rotate();
+			}
+
+			void Renderer::FilterHqX::Rows::Load(const uint slot,const Input& input,const Lut& lut,const uint row)
+			{
+				const Input::Pixel* const NST_RESTRICT src = input.pixels + row * WIDTH;
+				uint* const NST_RESTRICT dstColors = colorRows[slot];
+				dword* const NST_RESTRICT dstYuv = yuvRows[slot];
+
+				for (uint x=0; x < WIDTH; ++x)
+				{
+					dstColors[1+x] = input.palette[src[x]];
+					dstYuv[1+x] = lut.yuv[dstColors[1+x]];
+				}
+
+				dstColors[0] = dstColors[1];
+				dstColors[1+WIDTH] = dstColors[WIDTH];
+				dstYuv[0] = dstYuv[1];
+				dstYuv[1+WIDTH] = dstYuv[WIDTH];
+			}
+
+			void Renderer::FilterHqX::Rows::Rotate()
+			{
+				for (uint i=0; i < 3; ++i)
+				{
+					colors[i] = colorRows[(top + i) % 3];
+					yuv[i] = yuvRows[(top + i) % 3];
+				}
+
+				UpdatePatterns();
+			}
+
+			void Renderer::FilterHqX::Rows::UpdatePatterns()
+			{
+				// all of a row's patterns at once, four pixels and one neighbor per step
+
+				const __m128i zero = _mm_setzero_si128();
+				const __m128i mask = _mm_set1_epi32( Lut::YUV_MASK );
+
+				const uint* const neighborColors[8] =
+				{
+					colors[0], colors[0] + 1, colors[0] + 2,
+					colors[1],                colors[1] + 2,
+					colors[2], colors[2] + 1, colors[2] + 2
+				};
+
+				const dword* const neighborYuv[8] =
+				{
+					yuv[0], yuv[0] + 1, yuv[0] + 2,
+					yuv[1],             yuv[1] + 2,
+					yuv[2], yuv[2] + 1, yuv[2] + 2
+				};
+
+				dword bits[WIDTH];
+
+				for (uint x=0; x < WIDTH; x += 4)
+					_mm_storeu_si128( reinterpret_cast<__m128i*>(bits + x), zero );
+
+				for (uint n=0; n < 8; ++n)
+				{
+					const __m128i bit = _mm_set1_epi32( 1U << n );
+
+					for (uint x=0; x < WIDTH; x += 4)
+					{
+						const __m128i same = _mm_cmpeq_epi32
+						(
+							_mm_loadu_si128( reinterpret_cast<const __m128i*>(colors[1] + 1 + x) ),
+							_mm_loadu_si128( reinterpret_cast<const __m128i*>(neighborColors[n] + x) )
+						);
+
+						const __m128i alike = _mm_cmpeq_epi32
+						(
+							_mm_and_si128
+							(
+								_mm_sub_epi32
+								(
+									_mm_loadu_si128( reinterpret_cast<const __m128i*>(yuv[1] + 1 + x) ),
+									_mm_loadu_si128( reinterpret_cast<const __m128i*>(neighborYuv[n] + x) )
+								),
+								mask
+							),
+							zero
+						);
+
+						_mm_storeu_si128
+						(
+							reinterpret_cast<__m128i*>(bits + x),
+							_mm_or_si128
+							(
+								_mm_loadu_si128( reinterpret_cast<const __m128i*>(bits + x) ),
+								_mm_andnot_si128( _mm_or_si128( same, alike ), bit )
+							)
+						);
+					}
+				}
+
+				for (uint x=0; x < WIDTH; x += 16)
+				{
+					_mm_storeu_si128
+					(
+						reinterpret_cast<__m128i*>(patterns + x),
+						_mm_packus_epi16
+						(
+							_mm_packs_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>(bits + x + 0) ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(bits + x + 4) ) ),
+							_mm_packs_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>(bits + x + 8) ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(bits + x + 12) ) )
+						)
+					);
+				}
+			}
+
+			#endif
+
 			template<typename T>
 			struct Renderer::FilterHqX::Buffer
 			{
@@ -153,23 +361,48 @@ namespace Nes
 			};
 
 			template<typename T,dword R,dword G,dword B>
-			void Renderer::FilterHqX::Blit2x(const Input& input,const Output& output) const
+			void Renderer::FilterHqX::Blit2x(const Input& input,const Output& output,const uint first,const uint last) const
 			{
-				const byte* NST_RESTRICT src = reinterpret_cast<const byte*>(input.pixels);
+				byte* const target = static_cast<byte*>(output.pixels) + long(first * 2) * output.pitch;
 				const long pitch = output.pitch + output.pitch - (WIDTH*2 * sizeof(T));
 
 				T* NST_RESTRICT dst[2] =
 				{
-					static_cast<T*>(output.pixels) - 2,
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch) - 2
+					reinterpret_cast<T*>(target) - 2,
+					reinterpret_cast<T*>(target + output.pitch) - 2
 				};
 
-				for (uint y=HEIGHT; y; --y)
+			#ifdef NST_MM_INTRINSICS
+
+				Rows rows( input, lut, first );
+
+				for (uint y=first; y < last; ++y)
+				{
+					if (y != first)
+						rows.Next( input, lut );
+
+					Buffer<T> b;
+
+					for (uint x=0; x < WIDTH; ++x)
+					{
+						dst[0] += 2;
+						dst[1] += 2;
+
+						rows.Fetch( b.w, x );
+						b.Convert( lut );
+
+						const uint pattern = rows.GetPattern( x );
+
+			#else
+
+				const byte* NST_RESTRICT src = reinterpret_cast<const byte*>(input.pixels + first * WIDTH);
+
+				for (uint y=first; y < last; ++y)
 				{
 					const uint lines[2] =
 					{
-						y < HEIGHT ? WIDTH * sizeof(Input::Pixel) : 0,
-						y > 1      ? WIDTH * sizeof(Input::Pixel) : 0
+						y > 0        ? WIDTH * sizeof(Input::Pixel) : 0,
+						y < HEIGHT-1 ? WIDTH * sizeof(Input::Pixel) : 0
 					};
 
 					Buffer<T> b;
@@ -200,7 +433,9 @@ namespace Nes
 
 						b.Convert( lut );
 
-						const uint yuv5 = lut.yuv[b.w[4]];
+						const uint pattern = GetPattern( b.w );
+
+			#endif
 
 						#include "NstVideoFilterHq2x.inl"
 					}
@@ -211,24 +446,50 @@ namespace Nes
 			}
 
 			template<typename T,dword R,dword G,dword B>
-			void Renderer::FilterHqX::Blit3x(const Input& input,const Output& output) const
+			void Renderer::FilterHqX::Blit3x(const Input& input,const Output& output,const uint first,const uint last) const
 			{
-				const byte* NST_RESTRICT src = reinterpret_cast<const byte*>(input.pixels);
+				byte* const target = static_cast<byte*>(output.pixels) + long(first * 3) * output.pitch;
 				const long pitch = (output.pitch * 2) + output.pitch - (WIDTH*3 * sizeof(T));
 
 				T* NST_RESTRICT dst[3] =
 				{
-					static_cast<T*>(output.pixels) - 3,
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch) - 3,
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * 2) - 3
+					reinterpret_cast<T*>(target) - 3,
+					reinterpret_cast<T*>(target + output.pitch) - 3,
+					reinterpret_cast<T*>(target + output.pitch * 2) - 3
 				};
 
-				for (uint y=HEIGHT; y; --y)
+			#ifdef NST_MM_INTRINSICS
+
+				Rows rows( input, lut, first );
+
+				for (uint y=first; y < last; ++y)
+				{
+					if (y != first)
+						rows.Next( input, lut );
+
+					Buffer<T> b;
+
+					for (uint x=0; x < WIDTH; ++x)
+					{
+						dst[0] += 3;
+						dst[1] += 3;
+						dst[2] += 3;
+
+						rows.Fetch( b.w, x );
+						b.Convert( lut );
+
+						const uint pattern = rows.GetPattern( x );
+
+			#else
+
+				const byte* NST_RESTRICT src = reinterpret_cast<const byte*>(input.pixels + first * WIDTH);
+
+				for (uint y=first; y < last; ++y)
 				{
 					const uint lines[2] =
 					{
-						y < HEIGHT ? WIDTH * sizeof(Input::Pixel) : 0,
-						y > 1      ? WIDTH * sizeof(Input::Pixel) : 0
+						y > 0        ? WIDTH * sizeof(Input::Pixel) : 0,
+						y < HEIGHT-1 ? WIDTH * sizeof(Input::Pixel) : 0
 					};
 
 					Buffer<T> b;
@@ -260,7 +521,9 @@ namespace Nes
 
 						b.Convert( lut );
 
-						const uint yuv5 = lut.yuv[b.w[4]];
+						const uint pattern = GetPattern( b.w );
+
+			#endif
 
 						#include "NstVideoFilterHq3x.inl"
 					}
@@ -272,25 +535,52 @@ namespace Nes
 			}
 
 			template<typename T,dword R,dword G,dword B>
-			void Renderer::FilterHqX::Blit4x(const Input& input,const Output& output) const
+			void Renderer::FilterHqX::Blit4x(const Input& input,const Output& output,const uint first,const uint last) const
 			{
-				const byte* NST_RESTRICT src = reinterpret_cast<const byte*>(input.pixels);
+				byte* const target = static_cast<byte*>(output.pixels) + long(first * 4) * output.pitch;
 				const long pitch = (output.pitch * 3) + output.pitch - (WIDTH*4 * sizeof(T));
 
 				T* NST_RESTRICT dst[4] =
 				{
-					static_cast<T*>(output.pixels) - 4,
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch) - 4,
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * 2) - 4,
-					reinterpret_cast<T*>(static_cast<byte*>(output.pixels) + output.pitch * 3) - 4
+					reinterpret_cast<T*>(target) - 4,
+					reinterpret_cast<T*>(target + output.pitch) - 4,
+					reinterpret_cast<T*>(target + output.pitch * 2) - 4,
+					reinterpret_cast<T*>(target + output.pitch * 3) - 4
 				};
 
-				for (uint y=HEIGHT; y; --y)
+			#ifdef NST_MM_INTRINSICS
+
+				Rows rows( input, lut, first );
+
+				for (uint y=first; y < last; ++y)
+				{
+					if (y != first)
+						rows.Next( input, lut );
+
+					Buffer<T> b;
+
+					for (uint x=0; x < WIDTH; ++x)
+					{
+						dst[0] += 4;
+						dst[1] += 4;
+						dst[2] += 4;
+						dst[3] += 4;
+
+						rows.Fetch( b.w, x );
+						b.Convert( lut );
+
+						const uint pattern = rows.GetPattern( x );
+
+			#else
+
+				const byte* NST_RESTRICT src = reinterpret_cast<const byte*>(input.pixels + first * WIDTH);
+
+				for (uint y=first; y < last; ++y)
 				{
 					const uint lines[2] =
 					{
-						y < HEIGHT ? WIDTH * sizeof(Input::Pixel) : 0,
-						y > 1      ? WIDTH * sizeof(Input::Pixel) : 0
+						y > 0        ? WIDTH * sizeof(Input::Pixel) : 0,
+						y < HEIGHT-1 ? WIDTH * sizeof(Input::Pixel) : 0
 					};
 
 					Buffer<T> b;
@@ -323,7 +613,9 @@ namespace Nes
 
 						b.Convert( lut );
 
-						const uint yuv5 = lut.yuv[b.w[4]];
+						const uint pattern = GetPattern( b.w );
+
+			#endif
 
 						#include "NstVideoFilterHq4x.inl"
 					}
@@ -26,6 +26,8 @@
 #ifndef NST_VIDEO_FILTER_HQX_H
 #define NST_VIDEO_FILTER_HQX_H
 
+#include "NstVideoBands.hpp"
+
 #ifdef NST_PRAGMA_ONCE
 #pragma once
 #endif
@@ -48,11 +50,12 @@ namespace Nes
 
 				~FilterHqX() {}
 
-				typedef void (FilterHqX::*Path)(const Input&,const Output&) const;
+				typedef void (FilterHqX::*Path)(const Input&,const Output&,uint,uint) const;
 
 				static Path GetPath(const RenderState&);
 
 				void Blit(const Input&,const Output&,uint);
+				static void BlitBand(const void*,uint,uint);
 				void Transform(const byte (&)[PALETTE][3],Input::Palette&) const;
 
 				template<dword R,dword G,dword B> static dword Interpolate1(dword,dword);
@@ -68,18 +71,24 @@ namespace Nes
 
 				inline dword Diff(uint,uint) const;
 
+			#ifndef NST_MM_INTRINSICS
+				inline uint GetPattern(const uint (&)[10]) const;
+			#endif
+
 				template<typename T,dword R,dword G,dword B>
-				void Blit2x(const Input&,const Output&) const;
+				void Blit2x(const Input&,const Output&,uint,uint) const;
 
 				template<typename T,dword R,dword G,dword B>
-				void Blit3x(const Input&,const Output&) const;
+				void Blit3x(const Input&,const Output&,uint,uint) const;
 
 				template<typename T,dword R,dword G,dword B>
-				void Blit4x(const Input&,const Output&) const;
+				void Blit4x(const Input&,const Output&,uint,uint) const;
 
 				template<typename T>
 				struct Buffer;
 
+				struct Rows;
+
 				struct Lut
 				{
 					Lut(bool,const byte (&)[3],dword* = NULL);
@@ -95,6 +104,13 @@ namespace Nes
 					const dword* const NST_RESTRICT rgb;
 				};
 
+				struct Job
+				{
+					const FilterHqX& filter;
+					const Input& input;
+					const Output& output;
+				};
+
 				const Path path;
 				const Lut lut;
 			};
@@ -32,44 +32,69 @@ namespace Nes
 	{
 		namespace Video
 		{
+			// Plain indexed loops over restrict pointers. Compilers unroll and
+			// schedule these better than anything hand written, and there is
+			// no gather that beats scalar loads from a 2 KB palette.
+
 			template<typename T>
 			void Renderer::FilterNone::BlitAligned(const Input& input,const Output& output)
 			{
-				const Input::Pixel* NST_RESTRICT src = input.pixels;
-				T* NST_RESTRICT dst = static_cast<T*>(output.pixels);
+				const Input::Pixel* const NST_RESTRICT src = input.pixels;
+				const dword* const NST_RESTRICT palette = input.palette;
+				T* const NST_RESTRICT dst = static_cast<T*>(output.pixels);
 
-				for (uint prefetched=*src++, i=PIXELS; i; --i)
-				{
-					const dword reg = input.palette[prefetched];
-					prefetched = *src++;
-					*dst++ = reg;
-				}
+				for (uint i=0; i < PIXELS; ++i)
+					dst[i] = palette[src[i]];
 			}
 
 			template<typename T>
 			void Renderer::FilterNone::BlitUnaligned(const Input& input,const Output& output)
 			{
 				const Input::Pixel* NST_RESTRICT src = input.pixels;
-				T* NST_RESTRICT dst = static_cast<T*>(output.pixels);
+				const dword* const NST_RESTRICT palette = input.palette;
+				byte* NST_RESTRICT dst = static_cast<byte*>(output.pixels);
 
-				const long pad = output.pitch - WIDTH * sizeof(T);
+				for (uint y=HEIGHT; y; --y)
+				{
+					T* const NST_RESTRICT line = reinterpret_cast<T*>(dst);
+
+					for (uint x=0; x < WIDTH; ++x)
+						line[x] = palette[src[x]];
+
+					src += WIDTH;
+					dst += output.pitch;
+				}
+			}
 
-				for (uint prefetched=*src++, y=HEIGHT; y; --y)
+			void Renderer::FilterNone::BlitPacked(const Input& input,const Output& output)
+			{
+				const Input::Pixel* NST_RESTRICT src = input.pixels;
+				const dword* const NST_RESTRICT palette = input.palette;
+				byte* NST_RESTRICT dst = static_cast<byte*>(output.pixels);
+
+				for (uint y=HEIGHT; y; --y)
 				{
-					for (uint x=WIDTH; x; --x)
+					for (uint x=0; x < WIDTH; ++x)
 					{
-						const dword reg = input.palette[prefetched];
-						prefetched = *src++;
-						*dst++ = reg;
+						const dword reg = palette[src[x]];
+
+						dst[x*3+0] = reg >> 0 & 0xFF;
+						dst[x*3+1] = reg >> 8 & 0xFF;
+						dst[x*3+2] = reg >> 16 & 0xFF;
 					}
 
-					dst = reinterpret_cast<T*>(reinterpret_cast<byte*>(dst) + pad);
+					src += WIDTH;
+					dst += output.pitch;
 				}
 			}
 
 			void Renderer::FilterNone::Blit(const Input& input,const Output& output,uint)
 			{
-				if (format.bpp == 32)
+				if (format.bpp == 24)
+				{
+					BlitPacked( input, output );
+				}
+				else if (format.bpp == 32)
 				{
 					if (output.pitch == WIDTH * sizeof(dword))
 						BlitAligned<dword>( input, output );
@@ -90,16 +115,13 @@ namespace Nes
 			#endif
 
 			Renderer::FilterNone::FilterNone(const RenderState& state)
-			: Filter(state)
-			{
-				NST_COMPILE_ASSERT( Video::Screen::PIXELS_PADDING >= 1 );
-			}
+			: Filter(state) {}
 
 			bool Renderer::FilterNone::Check(const RenderState& state)
 			{
 				return
 				(
-					(state.bits.count == 16 || state.bits.count == 32) &&
+					(state.bits.count == 16 || state.bits.count == 24 || state.bits.count == 32) &&
 					(state.width == WIDTH && state.height == HEIGHT)
 				);
 			}
@@ -54,6 +54,8 @@ namespace Nes
 
 				template<typename T>
 				static void BlitUnaligned(const Input&,const Output&);
+
+				static void BlitPacked(const Input&,const Output&);
 			};
 		}
 	}
@@ -27,6 +27,10 @@
 #include "NstVideoFilterNtsc.hpp"
 #include "NstFpuPrecision.hpp"
 
+#ifdef NST_MM_INTRINSICS
+#include <emmintrin.h>
+#endif
+
 namespace Nes
 {
 	namespace Core
@@ -35,57 +39,188 @@ namespace Nes
 		{
 			void Renderer::FilterNtsc::Blit(const Input& input,const Output& output,uint phase)
 			{
-				(*this.*path)( input, output, phase );
+				NST_ASSERT( phase < 3 );
+
+				const Job job = { lut, input, output, phase & lut.noFieldMerging };
+				Bands::Run( path, &job, HEIGHT );
 			}
 
 			template<typename Pixel,uint BITS>
-			void Renderer::FilterNtsc::BlitType(const Input& input,const Output& output,uint phase) const
+			void Renderer::FilterNtsc::BlitType(const void* const data,const uint first,const uint last)
 			{
-				NST_ASSERT( phase < 3 );
+				const Job& job = *static_cast<const Job*>(data);
+
+				const Input::Pixel* NST_RESTRICT src = job.input.pixels + first * WIDTH;
+				byte* NST_RESTRICT dst = static_cast<byte*>(job.output.pixels) + long(first) * job.output.pitch;
+
+				// the burst phase steps by one every row, so a band starts where the rows above it leave off
+
+				for (uint y=first, phase=(job.phase + first) % 3; y < last; ++y, phase = (phase + 1) % 3)
+				{
+					BlitRow<Pixel,BITS>( job.lut, src, reinterpret_cast<Pixel*>(dst), phase );
+
+					src += WIDTH;
+					dst += job.output.pitch;
+				}
+			}
 
-				const Input::Pixel* NST_RESTRICT src = input.pixels;
-				Pixel* NST_RESTRICT dst = static_cast<Pixel*>(output.pixels);
-				const long pad = output.pitch - (NTSC_WIDTH-7) * sizeof(Pixel);
+			template<typename Pixel,uint BITS>
+			inline void Renderer::FilterNtsc::BlitRow(const Lut& lut,const Input::Pixel* NST_RESTRICT src,Pixel* NST_RESTRICT dst,const uint phase)
+			{
+			#ifdef NST_MM_INTRINSICS
+
+				// Same sums as NES_NTSC_RGB_OUT, four output pixels at a time. Of every 7
+				// outputs, 0-1 and 2-3 use different kernels for their second term while
+				// 4-6 share one set, so each group of 7 takes two vectors.
 
-				phase &= lut.noFieldMerging;
+				const nes_ntsc_rgb_t* const table = lut.table[0] + phase * nes_ntsc_burst_size;
 
-				for (uint y=HEIGHT; y; --y)
+				const nes_ntsc_rgb_t* k0 = table + lut.black * nes_ntsc_entry_size;
+				const nes_ntsc_rgb_t* k1 = k0;
+				const nes_ntsc_rgb_t* k2 = table + *src++ * nes_ntsc_entry_size;
+				const nes_ntsc_rgb_t* x0;
+				const nes_ntsc_rgb_t* x1 = k0;
+				const nes_ntsc_rgb_t* x2 = k0;
+
+				const __m128i clampMask = _mm_set1_epi32( nes_ntsc_clamp_mask );
+				const __m128i clampAdd = _mm_set1_epi32( nes_ntsc_clamp_add );
+
+				for (uint i=0; i < NTSC_WIDTH/7; ++i, src += 3, dst += 7)
 				{
-					NES_NTSC_BEGIN_ROW( &lut, phase, lut.black, lut.black, *src++ );
+					const bool border = (i == NTSC_WIDTH/7-1);
+
+					x0 = k0;
+					k0 = table + (border ? lut.black : src[0]) * nes_ntsc_entry_size;
+
+					const nes_ntsc_rgb_t* const n1 = table + (border ? lut.black : src[1]) * nes_ntsc_entry_size;
+
+					__m128i lo = _mm_add_epi32
+					(
+						_mm_add_epi32
+						(
+							_mm_add_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>(k0) ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(x0 + 7) ) ),
+							_mm_add_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>(k2 + 31) ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(x2 + 38) ) )
+						),
+						_mm_add_epi32
+						(
+							_mm_unpacklo_epi64( _mm_loadl_epi64( reinterpret_cast<const __m128i*>(k1 + 19) ), _mm_loadl_epi64( reinterpret_cast<const __m128i*>(n1 + 14) ) ),
+							_mm_unpacklo_epi64( _mm_loadl_epi64( reinterpret_cast<const __m128i*>(x1 + 26) ), _mm_loadl_epi64( reinterpret_cast<const __m128i*>(k1 + 21) ) )
+						)
+					);
+
+					x1 = k1;
+					k1 = n1;
+					x2 = k2;
+					k2 = table + (border ? lut.black : src[2]) * nes_ntsc_entry_size;
+
+					__m128i hi = _mm_add_epi32
+					(
+						_mm_add_epi32
+						(
+							_mm_add_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>(k0 + 4) ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(x0 + 11) ) ),
+							_mm_add_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>(k1 + 16) ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(x1 + 23) ) )
+						),
+						_mm_add_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>(k2 + 28) ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(x2 + 35) ) )
+					);
+
+					// NES_NTSC_CLAMP_
 
-					for (const Input::Pixel* const end=src+(NTSC_WIDTH/7*3-3); src != end; src += 3, dst += 7)
+					__m128i sub = _mm_and_si128( _mm_srli_epi32( lo, 9 ), clampMask );
+					__m128i clamp = _mm_sub_epi32( clampAdd, sub );
+					lo = _mm_and_si128( _mm_or_si128( lo, clamp ), _mm_sub_epi32( clamp, sub ) );
+
+					sub = _mm_and_si128( _mm_srli_epi32( hi, 9 ), clampMask );
+					clamp = _mm_sub_epi32( clampAdd, sub );
+					hi = _mm_and_si128( _mm_or_si128( hi, clamp ), _mm_sub_epi32( clamp, sub ) );
+
+					// NES_NTSC_RGB_OUT_
+
+					if (BITS == 32)
 					{
-						NES_NTSC_COLOR_IN( 0, src[0] );
-						NES_NTSC_RGB_OUT( 0, dst[0], BITS );
-						NES_NTSC_RGB_OUT( 1, dst[1], BITS );
-
-						NES_NTSC_COLOR_IN( 1, src[1] );
-						NES_NTSC_RGB_OUT( 2, dst[2], BITS );
-						NES_NTSC_RGB_OUT( 3, dst[3], BITS );
-
-						NES_NTSC_COLOR_IN( 2, src[2] );
-						NES_NTSC_RGB_OUT( 4, dst[4], BITS );
-						NES_NTSC_RGB_OUT( 5, dst[5], BITS );
-						NES_NTSC_RGB_OUT( 6, dst[6], BITS );
+						lo = _mm_or_si128
+						(
+							_mm_and_si128( _mm_srli_epi32( lo, 5 ), _mm_set1_epi32( 0xFF0000 ) ),
+							_mm_or_si128( _mm_and_si128( _mm_srli_epi32( lo, 3 ), _mm_set1_epi32( 0xFF00 ) ), _mm_and_si128( _mm_srli_epi32( lo, 1 ), _mm_set1_epi32( 0xFF ) ) )
+						);
+
+						hi = _mm_or_si128
+						(
+							_mm_and_si128( _mm_srli_epi32( hi, 5 ), _mm_set1_epi32( 0xFF0000 ) ),
+							_mm_or_si128( _mm_and_si128( _mm_srli_epi32( hi, 3 ), _mm_set1_epi32( 0xFF00 ) ), _mm_and_si128( _mm_srli_epi32( hi, 1 ), _mm_set1_epi32( 0xFF ) ) )
+						);
+
+						_mm_storeu_si128( reinterpret_cast<__m128i*>(dst), lo );
+						_mm_storel_epi64( reinterpret_cast<__m128i*>(dst + 4), hi );
+						dst[6] = _mm_cvtsi128_si32( _mm_srli_si128( hi, 8 ) );
 					}
+					else
+					{
+						const uint shift = (BITS == 16 ? 13 : 14);
+						const __m128i r = _mm_set1_epi32( BITS == 16 ? 0xF800 : 0x7C00 );
+						const __m128i g = _mm_set1_epi32( BITS == 16 ? 0x07E0 : 0x03E0 );
+						const __m128i b = _mm_set1_epi32( 0x001F );
 
-					NES_NTSC_COLOR_IN( 0, lut.black );
+						lo = _mm_or_si128
+						(
+							_mm_and_si128( _mm_srli_epi32( lo, shift ), r ),
+							_mm_or_si128( _mm_and_si128( _mm_srli_epi32( lo, shift-5 ), g ), _mm_and_si128( _mm_srli_epi32( lo, 4 ), b ) )
+						);
+
+						hi = _mm_or_si128
+						(
+							_mm_and_si128( _mm_srli_epi32( hi, shift ), r ),
+							_mm_or_si128( _mm_and_si128( _mm_srli_epi32( hi, shift-5 ), g ), _mm_and_si128( _mm_srli_epi32( hi, 4 ), b ) )
+						);
+
+						// sign extend so the saturating pack keeps all 16 bits
+
+						const __m128i packed = _mm_packs_epi32
+						(
+							_mm_srai_epi32( _mm_slli_epi32( lo, 16 ), 16 ),
+							_mm_srai_epi32( _mm_slli_epi32( hi, 16 ), 16 )
+						);
+
+						_mm_storel_epi64( reinterpret_cast<__m128i*>(dst), packed );
+						dst[4] = _mm_extract_epi16( packed, 4 );
+						dst[5] = _mm_extract_epi16( packed, 5 );
+						dst[6] = _mm_extract_epi16( packed, 6 );
+					}
+				}
+
+			#else
+
+				NES_NTSC_BEGIN_ROW( &lut, phase, lut.black, lut.black, *src++ );
+
+				for (const Input::Pixel* const end=src+(NTSC_WIDTH/7*3-3); src != end; src += 3, dst += 7)
+				{
+					NES_NTSC_COLOR_IN( 0, src[0] );
 					NES_NTSC_RGB_OUT( 0, dst[0], BITS );
 					NES_NTSC_RGB_OUT( 1, dst[1], BITS );
 
-					NES_NTSC_COLOR_IN( 1, lut.black );
+					NES_NTSC_COLOR_IN( 1, src[1] );
 					NES_NTSC_RGB_OUT( 2, dst[2], BITS );
 					NES_NTSC_RGB_OUT( 3, dst[3], BITS );
 
-					NES_NTSC_COLOR_IN( 2, lut.black );
+					NES_NTSC_COLOR_IN( 2, src[2] );
 					NES_NTSC_RGB_OUT( 4, dst[4], BITS );
 					NES_NTSC_RGB_OUT( 5, dst[5], BITS );
 					NES_NTSC_RGB_OUT( 6, dst[6], BITS );
+				}
 
-					dst = reinterpret_cast<Pixel*>(reinterpret_cast<byte*>(dst) + pad);
+				NES_NTSC_COLOR_IN( 0, lut.black );
+				NES_NTSC_RGB_OUT( 0, dst[0], BITS );
+				NES_NTSC_RGB_OUT( 1, dst[1], BITS );
 
-					phase = (phase + 1) % 3;
-				}
+				NES_NTSC_COLOR_IN( 1, lut.black );
+				NES_NTSC_RGB_OUT( 2, dst[2], BITS );
+				NES_NTSC_RGB_OUT( 3, dst[3], BITS );
+
+				NES_NTSC_COLOR_IN( 2, lut.black );
+				NES_NTSC_RGB_OUT( 4, dst[4], BITS );
+				NES_NTSC_RGB_OUT( 5, dst[5], BITS );
+				NES_NTSC_RGB_OUT( 6, dst[6], BITS );
+
+			#endif
 			}
 
 			#ifdef NST_MSVC_OPTIMIZE
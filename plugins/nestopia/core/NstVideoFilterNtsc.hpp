@@ -26,6 +26,7 @@
 #define NST_VIDEO_FILTER_NTSC_H
 
 #include "../nes_ntsc/nes_ntsc.h"
+#include "NstVideoBands.hpp"
 
 #ifdef NST_PRAGMA_ONCE
 #pragma once
@@ -54,12 +55,12 @@ namespace Nes
 					NTSC_WIDTH = 602
 				};
 
-				typedef void (FilterNtsc::*Path)(const Input&,const Output&,uint) const;
+				typedef Bands::Routine Path;
 
 				void Blit(const Input&,const Output&,uint);
 
 				template<typename T,uint BITS>
-				void BlitType(const Input&,const Output&,uint) const;
+				static void BlitType(const void*,uint,uint);
 
 				class Lut : public nes_ntsc_t
 				{
@@ -78,6 +79,17 @@ namespace Nes
 					const uint black;
 				};
 
+				struct Job
+				{
+					const Lut& lut;
+					const Input& input;
+					const Output& output;
+					const uint phase;
+				};
+
+				template<typename T,uint BITS>
+				static inline void BlitRow(const Lut&,const Input::Pixel*,T*,uint);
+
 				static Path GetPath(const RenderState&,const Lut&);
 
 				const Path path;
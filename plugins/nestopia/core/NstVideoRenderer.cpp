@@ -801,14 +801,14 @@ namespace Nes
 					if (state.update)
 						UpdateFilter( input );
 
-					if (Output::lockCallback( output ))
+					if (output.lockCallback( output ))
 					{
-						NST_VERIFY( std::labs(output.pitch) >= dword(state.width) << (filter->format.bpp / 16) );
+						NST_VERIFY( std::labs(output.pitch) >= dword(state.width) * (filter->format.bpp / 8) );
 
-						if (std::labs(output.pitch) >= dword(state.width) << (filter->format.bpp / 16))
+						if (std::labs(output.pitch) >= dword(state.width) * (filter->format.bpp / 8))
 							filter->Blit( input, output, burstPhase );
 
-						Output::unlockCallback( output );
+						output.unlockCallback( output );
 					}
 				}
 			}
@@ -44,13 +44,15 @@ namespace Nes
 			#endif
 			};
 
+			// zlib levels, any level from 1 to 9 may be passed
 			enum Compression
 			{
-				NORMAL_COMPRESSION,
-				BEST_COMPRESSION
+				FAST_COMPRESSION = 1,
+				NORMAL_COMPRESSION = 6,
+				BEST_COMPRESSION = 9
 			};
 
-			ulong NST_CALL Compress(const byte*,ulong,byte*,ulong,Compression);
+			ulong NST_CALL Compress(const byte*,ulong,byte*,ulong,uint);
 			ulong NST_CALL Uncompress(const byte*,ulong,byte*,ulong);
 		}
 	}
@@ -63,7 +63,7 @@ namespace Nes
 
 			if (Core::BarcodeReader* const barcodeReader = Query())
 			{
-				static uint extra = 0x1234;
+				static thread_local uint extra = 0x1234;
 				std::srand( std::time(NULL) + extra++ );
 
 				if (!barcodeReader->IsDigitsSupported( MIN_DIGITS ))
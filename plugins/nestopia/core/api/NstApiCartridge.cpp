@@ -35,7 +35,10 @@ namespace Nes
 {
 	namespace Api
 	{
-		Cartridge::ChooseProfileCaller Cartridge::chooseProfileCallback;
+		Cartridge::Callbacks& Cartridge::GetCallbacks(Core::Machine& machine) throw()
+		{
+			return machine.callbacks.cartridge;
+		}
 
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("s", on)
@@ -59,8 +59,7 @@ namespace Nes
 			* @param instance emulator instance
 			*/
 			template<typename T>
-			Cartridge(T& instance)
-			: Base(instance) {}
+			Cartridge(T& instance);
 
 			/**
 			* Cartridge profile context.
@@ -1368,9 +1367,20 @@ namespace Nes
 			/**
 			* Cartridge profile chooser callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static ChooseProfileCaller chooseProfileCallback;
+			ChooseProfileCaller& chooseProfileCallback;
+
+			/**
+			* Callback storage of an emulator instance.
+			*
+			* Used internally by the core.
+			*/
+			struct Callbacks;
+
+		private:
+
+			static Callbacks& GetCallbacks(Core::Machine&) throw();
 		};
 
 		/**
@@ -1385,6 +1395,18 @@ namespace Nes
 				return function ? function( userdata, profiles, names, count ) : CHOOSE_DEFAULT_PROFILE;
 			}
 		};
+
+		struct Cartridge::Callbacks
+		{
+			ChooseProfileCaller chooseProfileCallback;
+		};
+
+		template<typename T>
+		Cartridge::Cartridge(T& instance)
+		:
+		Base                  (instance),
+		chooseProfileCallback (GetCallbacks(emulator).chooseProfileCallback)
+		{}
 	}
 }
 
@@ -50,7 +50,8 @@
 //
 // NST_MM_INTRINSICS         - For MMX/SSE compiler intrinsics support through
 //                             xmmintrin.h/emmintrin.h/mmintrin.h. Auto-defined if
-//                             compiler is Win32 MSVC and _M_IX86 is defined.
+//                             compiler is Win32 MSVC and _M_IX86 or _M_X64 is defined,
+//                             or if compiler is GCC and __SSE2__ is defined.
 //
 // NST_CALL <attribute>      - Compiler/platform specific calling convention for non-member
 //                             functions. Placed between return type and function name, e.g
@@ -130,5 +131,9 @@
 //
 // NST_NO_2XSAI   - 2xSaI video filter
 //
+// NST_NO_THREADED_DISPATCH - Computed goto dispatch of CPU instructions. Falls back
+//                            on the portable opcode function table, which is what
+//                            non-GCC compilers always use. Emulation is identical.
+//
 ////////////////////////////////////////////////////////////////////////////////////////
 */
@@ -54,6 +54,8 @@ namespace Nes
 			Core::Input::Controllers* input
 		)   throw()
 		{
+			Core::Callbacks::Scope scope( machine.callbacks );
+
 			return machine.tracker.Execute( machine, video, sound, input );
 		}
 
@@ -74,7 +74,7 @@ namespace Nes
 			/**
 			* Executes one frame.
 			*
-			* @param video video context object or NULL to skip output
+			* @param video video context object or NULL to skip output, in which case the frame isn't rendered either unless a light gun needs it
 			* @param sound sound context object or NULL to skip output
 			* @param input input context object or NULL to skip output
 			* @return result code
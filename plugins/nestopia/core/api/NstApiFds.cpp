@@ -34,13 +34,15 @@ namespace Nes
 {
 	namespace Api
 	{
+		Fds::Callbacks& Fds::GetCallbacks(Core::Machine& machine) throw()
+		{
+			return machine.callbacks.fds;
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("s", on)
 		#endif
 
-		Fds::DiskCaller Fds::diskCallback;
-		Fds::DriveCaller Fds::driveCallback;
-
 		Fds::DiskData::File::File() throw()
 		:
 		id      (0),
@@ -78,6 +80,8 @@ namespace Nes
 
 		Result Fds::InsertDisk(uint disk,uint side) throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			if (emulator.Is(Machine::DISK) && !emulator.tracker.IsLocked())
 				return emulator.tracker.TryResync( static_cast<Core::Fds*>(emulator.image)->InsertDisk( disk, side ) );
 
@@ -96,6 +100,8 @@ namespace Nes
 
 		Result Fds::EjectDisk() throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			if (emulator.Is(Machine::DISK) && !emulator.tracker.IsLocked())
 				return emulator.tracker.TryResync( static_cast<Core::Fds*>(emulator.image)->EjectDisk() );
 
@@ -136,7 +142,7 @@ namespace Nes
 					stream.Seek( offset );
 				}
 
-				Core::Fds::SetBios( stdStream );
+				emulator.fdsBios.Set( stdStream );
 			}
 			catch (Result result)
 			{
@@ -158,7 +164,7 @@ namespace Nes
 		{
 			try
 			{
-				return Core::Fds::GetBios( stream );
+				return emulator.fdsBios.Get( stream );
 			}
 			catch (Result result)
 			{
@@ -176,7 +182,7 @@ namespace Nes
 
 		bool Fds::HasBIOS() const throw()
 		{
-			return Core::Fds::HasBios();
+			return emulator.fdsBios.Available();
 		}
 
 		uint Fds::GetNumDisks() const throw()
@@ -61,8 +61,7 @@ namespace Nes
 			* @param instance emulator instance
 			*/
 			template<typename T>
-			Fds(T& instance)
-			: Base(instance) {}
+			Fds(T& instance);
 
 			enum
 			{
@@ -100,7 +99,7 @@ namespace Nes
 			Result EjectDisk() throw();
 
 			/**
-			* Sets BIOS.
+			* Sets the BIOS of this emulator instance.
 			*
 			* @param input stream to ROM binary or iNES file, set to NULL to remove current BIOS
 			* @result result code
@@ -328,16 +327,27 @@ namespace Nes
 			/**
 			* Disk event callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static DiskCaller diskCallback;
+			DiskCaller& diskCallback;
 
 			/**
 			* Drive event callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static DriveCaller driveCallback;
+			DriveCaller& driveCallback;
+
+			/**
+			* Callback storage of an emulator instance.
+			*
+			* Used internally by the core.
+			*/
+			struct Callbacks;
+
+		private:
+
+			static Callbacks& GetCallbacks(Core::Machine&) throw();
 		};
 
 		/**
@@ -367,6 +377,20 @@ namespace Nes
 					function( userdata, motor );
 			}
 		};
+
+		struct Fds::Callbacks
+		{
+			DiskCaller diskCallback;
+			DriveCaller driveCallback;
+		};
+
+		template<typename T>
+		Fds::Fds(T& instance)
+		:
+		Base          (instance),
+		diskCallback  (GetCallbacks(emulator).diskCallback),
+		driveCallback (GetCallbacks(emulator).driveCallback)
+		{}
 	}
 }
 
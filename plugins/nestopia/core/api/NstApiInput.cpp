@@ -62,38 +62,16 @@ namespace Nes
 
 	namespace Api
 	{
-		Input::ControllerCaller Input::controllerCallback;
-		Input::AdapterCaller Input::adapterCallback;
+		Input::Callbacks& Input::GetCallbacks(Core::Machine& machine) throw()
+		{
+			return machine.callbacks.input;
+		}
 	}
 
 	namespace Core
 	{
 		namespace Input
 		{
-			Controllers::PollCaller2< Controllers::Pad               > Controllers::Pad::callback;
-			Controllers::PollCaller1< Controllers::Zapper            > Controllers::Zapper::callback;
-			Controllers::PollCaller1< Controllers::Paddle            > Controllers::Paddle::callback;
-			Controllers::PollCaller1< Controllers::PowerPad          > Controllers::PowerPad::callback;
-			Controllers::PollCaller1< Controllers::PowerGlove        > Controllers::PowerGlove::callback;
-			Controllers::PollCaller1< Controllers::Mouse             > Controllers::Mouse::callback;
-			Controllers::PollCaller1< Controllers::FamilyTrainer     > Controllers::FamilyTrainer::callback;
-			Controllers::PollCaller3< Controllers::FamilyKeyboard    > Controllers::FamilyKeyboard::callback;
-			Controllers::PollCaller3< Controllers::SuborKeyboard     > Controllers::SuborKeyboard::callback;
-			Controllers::PollCaller3< Controllers::DoremikkoKeyboard > Controllers::DoremikkoKeyboard::callback;
-			Controllers::PollCaller1< Controllers::HoriTrack         > Controllers::HoriTrack::callback;
-			Controllers::PollCaller1< Controllers::Pachinko          > Controllers::Pachinko::callback;
-			Controllers::PollCaller1< Controllers::VsSystem          > Controllers::VsSystem::callback;
-			Controllers::PollCaller1< Controllers::OekaKidsTablet    > Controllers::OekaKidsTablet::callback;
-			Controllers::PollCaller1< Controllers::KonamiHyperShot   > Controllers::KonamiHyperShot::callback;
-			Controllers::PollCaller1< Controllers::BandaiHyperShot   > Controllers::BandaiHyperShot::callback;
-			Controllers::PollCaller1< Controllers::CrazyClimber      > Controllers::CrazyClimber::callback;
-			Controllers::PollCaller2< Controllers::Mahjong           > Controllers::Mahjong::callback;
-			Controllers::PollCaller2< Controllers::ExcitingBoxing    > Controllers::ExcitingBoxing::callback;
-			Controllers::PollCaller1< Controllers::TopRider          > Controllers::TopRider::callback;
-			Controllers::PollCaller2< Controllers::PokkunMoguraa     > Controllers::PokkunMoguraa::callback;
-			Controllers::PollCaller1< Controllers::PartyTap          > Controllers::PartyTap::callback;
-			Controllers::PollCaller1< Controllers::KaraokeStudio     > Controllers::KaraokeStudio::callback;
-
 			Controllers::PowerPad::PowerPad() throw()
 			{
 				std::fill( sideA, sideA + NUM_SIDE_A_BUTTONS, false );
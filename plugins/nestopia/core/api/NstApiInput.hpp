@@ -115,7 +115,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,Pad&,uint);
 
-					static PollCaller2<Pad> callback;
+					PollCaller2<Pad> callback;
 				};
 
 				/**
@@ -132,7 +132,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,Zapper&);
 
-					static PollCaller1<Zapper> callback;
+					PollCaller1<Zapper> callback;
 				};
 
 				/**
@@ -148,7 +148,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,Paddle&);
 
-					static PollCaller1<Paddle> callback;
+					PollCaller1<Paddle> callback;
 				};
 
 				/**
@@ -169,7 +169,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,PowerPad&);
 
-					static PollCaller1<PowerPad> callback;
+					PollCaller1<PowerPad> callback;
 				};
 
 				/**
@@ -209,7 +209,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,PowerGlove&);
 
-					static PollCaller1<PowerGlove> callback;
+					PollCaller1<PowerGlove> callback;
 				};
 
 				/**
@@ -226,7 +226,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,Mouse&);
 
-					static PollCaller1<Mouse> callback;
+					PollCaller1<Mouse> callback;
 				};
 
 				/**
@@ -247,7 +247,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,FamilyTrainer&);
 
-					static PollCaller1<FamilyTrainer> callback;
+					PollCaller1<FamilyTrainer> callback;
 				};
 
 				/**
@@ -267,7 +267,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,FamilyKeyboard&,uint,uint);
 
-					static PollCaller3<FamilyKeyboard> callback;
+					PollCaller3<FamilyKeyboard> callback;
 				};
 
 				/**
@@ -287,7 +287,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,SuborKeyboard&,uint,uint);
 
-					static PollCaller3<SuborKeyboard> callback;
+					PollCaller3<SuborKeyboard> callback;
 				};
 
 				/**
@@ -321,7 +321,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,DoremikkoKeyboard&,uint,uint);
 
-					static PollCaller3<DoremikkoKeyboard> callback;
+					PollCaller3<DoremikkoKeyboard> callback;
 				};
 
 				/**
@@ -357,7 +357,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,HoriTrack&);
 
-					static PollCaller1<HoriTrack> callback;
+					PollCaller1<HoriTrack> callback;
 				};
 
 				/**
@@ -391,7 +391,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,Pachinko&);
 
-					static PollCaller1<Pachinko> callback;
+					PollCaller1<Pachinko> callback;
 				};
 
 				/**
@@ -412,7 +412,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,VsSystem&);
 
-					static PollCaller1<VsSystem> callback;
+					PollCaller1<VsSystem> callback;
 				};
 
 				/**
@@ -429,7 +429,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,OekaKidsTablet&);
 
-					static PollCaller1<OekaKidsTablet> callback;
+					PollCaller1<OekaKidsTablet> callback;
 				};
 
 				/**
@@ -452,7 +452,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,KonamiHyperShot&);
 
-					static PollCaller1<KonamiHyperShot> callback;
+					PollCaller1<KonamiHyperShot> callback;
 				};
 
 				/**
@@ -470,7 +470,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,BandaiHyperShot&);
 
-					static PollCaller1<BandaiHyperShot> callback;
+					PollCaller1<BandaiHyperShot> callback;
 				};
 
 				/**
@@ -494,7 +494,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,CrazyClimber&);
 
-					static PollCaller1<CrazyClimber> callback;
+					PollCaller1<CrazyClimber> callback;
 				};
 
 				/**
@@ -538,7 +538,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,Mahjong&,uint);
 
-					static PollCaller2<Mahjong> callback;
+					PollCaller2<Mahjong> callback;
 				};
 
 				/**
@@ -568,7 +568,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,ExcitingBoxing&,uint);
 
-					static PollCaller2<ExcitingBoxing> callback;
+					PollCaller2<ExcitingBoxing> callback;
 				};
 
 				/**
@@ -595,7 +595,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,TopRider&);
 
-					static PollCaller1<TopRider> callback;
+					PollCaller1<TopRider> callback;
 				};
 
 				/**
@@ -622,7 +622,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,PokkunMoguraa&,uint);
 
-					static PollCaller2<PokkunMoguraa> callback;
+					PollCaller2<PokkunMoguraa> callback;
 				};
 
 				/**
@@ -647,7 +647,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,PartyTap&);
 
-					static PollCaller1<PartyTap> callback;
+					PollCaller1<PartyTap> callback;
 				};
 
 				/**
@@ -669,7 +669,7 @@ namespace Nes
 
 					typedef bool (NST_CALLBACK *PollCallback) (void*,KaraokeStudio&);
 
-					static PollCaller1<KaraokeStudio> callback;
+					PollCaller1<KaraokeStudio> callback;
 				};
 
 				Pad pad[NUM_PADS];
@@ -717,8 +717,7 @@ namespace Nes
 			* @param instance emulator instance
 			*/
 			template<typename T>
-			Input(T& instance)
-			: Base(instance) {}
+			Input(T& instance);
 
 			enum
 			{
@@ -959,16 +958,27 @@ namespace Nes
 			/**
 			* Controller event callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static ControllerCaller controllerCallback;
+			ControllerCaller& controllerCallback;
 
 			/**
 			* Adapter event callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static AdapterCaller adapterCallback;
+			AdapterCaller& adapterCallback;
+
+			/**
+			* Callback storage of an emulator instance.
+			*
+			* Used internally by the core.
+			*/
+			struct Callbacks;
+
+		private:
+
+			static Callbacks& GetCallbacks(Core::Machine&) throw();
 		};
 
 		/**
@@ -998,6 +1008,20 @@ namespace Nes
 					function( userdata, adapter );
 			}
 		};
+
+		struct Input::Callbacks
+		{
+			ControllerCaller controllerCallback;
+			AdapterCaller adapterCallback;
+		};
+
+		template<typename T>
+		Input::Input(T& instance)
+		:
+		Base               (instance),
+		controllerCallback (GetCallbacks(emulator).controllerCallback),
+		adapterCallback    (GetCallbacks(emulator).adapterCallback)
+		{}
 	}
 }
 
@@ -32,7 +32,10 @@ namespace Nes
 {
 	namespace Api
 	{
-		Machine::EventCaller Machine::eventCallback;
+		Machine::Callbacks& Machine::GetCallbacks(Core::Machine& machine) throw()
+		{
+			return machine.callbacks.machine;
+		}
 
 		uint Machine::Is(uint a) const throw()
 		{
@@ -214,6 +217,20 @@ namespace Nes
 			return result;
 		}
 
+		Result Machine::EnableIdleSkip(bool state) throw()
+		{
+			if (emulator.cpu.IsIdleSkipEnabled() == state)
+				return RESULT_NOP;
+
+			emulator.cpu.EnableIdleSkip( state );
+			return RESULT_OK;
+		}
+
+		bool Machine::IsIdleSkipEnabled() const throw()
+		{
+			return emulator.cpu.IsIdleSkipEnabled();
+		}
+
 		Result Machine::LoadState(std::istream& stream) throw()
 		{
 			if (!Is(GAME,ON) || IsLocked())
@@ -250,7 +267,14 @@ namespace Nes
 
 			try
 			{
-				Core::State::Saver saver( &stream, compression != NO_COMPRESSION, false );
+				Core::State::Saver saver
+				(
+					&stream,
+					compression == USE_COMPRESSION ? Core::State::Packing::Size() :
+					compression == FAST_COMPRESSION ? Core::State::Packing::Speed() :
+					Core::State::Packing(),
+					false
+				);
 				emulator.SaveState( saver );
 			}
 			catch (Result result)
@@ -269,6 +293,68 @@ namespace Nes
 			return RESULT_OK;
 		}
 
+		Result Machine::GetStateSize(ulong& size) const throw()
+		{
+			size = 0;
+			return SaveState( NULL, 0, size );
+		}
+
+		Result Machine::SaveState(void* data,ulong capacity,ulong& size) const throw()
+		{
+			if (!Is(GAME,ON))
+				return RESULT_ERR_NOT_READY;
+
+			try
+			{
+				Core::State::Saver saver( static_cast<byte*>(data), capacity );
+				emulator.SaveState( saver );
+				size = saver.Written();
+			}
+			catch (Result result)
+			{
+				return result;
+			}
+			catch (const std::bad_alloc&)
+			{
+				return RESULT_ERR_OUT_OF_MEMORY;
+			}
+			catch (...)
+			{
+				return RESULT_ERR_GENERIC;
+			}
+
+			return RESULT_OK;
+		}
+
+		Result Machine::LoadState(const void* data,ulong size) throw()
+		{
+			if (!Is(GAME,ON) || IsLocked())
+				return RESULT_ERR_NOT_READY;
+
+			try
+			{
+				emulator.tracker.Resync();
+				Core::State::Loader loader( static_cast<const byte*>(data), size, true );
+
+				if (emulator.LoadState( loader, true ))
+					return RESULT_OK;
+				else
+					return RESULT_ERR_INVALID_CRC;
+			}
+			catch (Result result)
+			{
+				return result;
+			}
+			catch (const std::bad_alloc&)
+			{
+				return RESULT_ERR_OUT_OF_MEMORY;
+			}
+			catch (...)
+			{
+				return RESULT_ERR_GENERIC;
+			}
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("", on)
 		#endif
@@ -59,8 +59,7 @@ namespace Nes
 			* @param instance emulator instance
 			*/
 			template<typename T>
-			Machine(T& instance)
-			: Base(instance) {}
+			Machine(T& instance);
 
 			enum
 			{
@@ -278,6 +277,25 @@ namespace Nes
 			*/
 			Result SetMode(Mode mode) throw();
 
+			/**
+			* Enables skipping of idle loops.
+			*
+			* Tight loops that only poll RAM, waiting for an interrupt to change
+			* it, are fast-forwarded to the next event. Emulation stays cycle
+			* exact, so this only affects speed. Disabled by default.
+			*
+			* @param state true to enable
+			* @return result code
+			*/
+			Result EnableIdleSkip(bool state=true) throw();
+
+			/**
+			* Checks if idle loops are skipped.
+			*
+			* @return true if enabled
+			*/
+			bool IsIdleSkipEnabled() const throw();
+
 			/**
 			* Internal compression on states.
 			*/
@@ -288,9 +306,14 @@ namespace Nes
 				*/
 				NO_COMPRESSION,
 				/**
-				* Compression enabled (default).
+				* Compression enabled (default), zlib at its best ratio.
+				*/
+				USE_COMPRESSION,
+				/**
+				* Nestopia's own fast LZ compression, cheap enough for every frame.
+				* Only readable by builds that know it.
 				*/
-				USE_COMPRESSION
+				FAST_COMPRESSION
 			};
 
 			/**
@@ -310,6 +333,33 @@ namespace Nes
 			*/
 			Result SaveState(std::ostream& stream,Compression compression=USE_COMPRESSION) const throw();
 
+			/**
+			* Returns the size of an uncompressed state saved to memory.
+			*
+			* @param size receives the number of bytes SaveState(void*,ulong,ulong&) will write
+			* @return result code
+			*/
+			Result GetStateSize(ulong& size) const throw();
+
+			/**
+			* Saves an uncompressed state into caller owned memory, without iostreams.
+			*
+			* @param data memory which the state will be written to
+			* @param capacity size of the memory in bytes
+			* @param size receives the number of bytes written
+			* @return result code, RESULT_ERR_OUT_OF_MEMORY if the state doesn't fit
+			*/
+			Result SaveState(void* data,ulong capacity,ulong& size) const throw();
+
+			/**
+			* Loads a state from memory, without iostreams.
+			*
+			* @param data state as written by either SaveState method
+			* @param size size of the state in bytes
+			* @return result code
+			*/
+			Result LoadState(const void* data,ulong size) throw();
+
 			/**
 			* Returns a machine state.
 			*
@@ -394,12 +444,21 @@ namespace Nes
 			/**
 			* Machine event callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static EventCaller eventCallback;
+			EventCaller& eventCallback;
+
+			/**
+			* Callback storage of an emulator instance.
+			*
+			* Used internally by the core.
+			*/
+			struct Callbacks;
 
 		private:
 
+			static Callbacks& GetCallbacks(Core::Machine&) throw();
+
 			Result Load(std::istream&,FavoredSystem,AskProfile,Patch*,uint);
 		};
 
@@ -416,6 +475,18 @@ namespace Nes
 					function( userdata, event, result );
 			}
 		};
+
+		struct Machine::Callbacks
+		{
+			EventCaller eventCallback;
+		};
+
+		template<typename T>
+		Machine::Machine(T& instance)
+		:
+		Base          (instance),
+		eventCallback (GetCallbacks(emulator).eventCallback)
+		{}
 	}
 }
 
@@ -23,6 +23,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////
 
 #include "../NstMachine.hpp"
+#include "../NstState.hpp"
 #include "NstApiTapeRecorder.hpp"
 #include "NstApiMovie.hpp"
 
@@ -30,25 +31,42 @@ namespace Nes
 {
 	namespace Api
 	{
+		Movie::Callbacks& Movie::GetCallbacks(Core::Machine& machine) throw()
+		{
+			return machine.callbacks.movie;
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("s", on)
 		#endif
 
-		Movie::EventCaller Movie::eventCallback;
-
 		Result Movie::Play(std::istream& stream) throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			Api::TapeRecorder(emulator).Stop();
 			return emulator.tracker.PlayMovie( emulator, stream );
 		}
 
-		Result Movie::Record(std::iostream& stream,How how) throw()
+		Result Movie::Record(std::iostream& stream,How how,Machine::Compression compression) throw()
 		{
-			return emulator.tracker.RecordMovie( emulator, stream, how == APPEND );
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
+			return emulator.tracker.RecordMovie
+			(
+				emulator,
+				stream,
+				how == APPEND,
+				compression == Machine::USE_COMPRESSION ? Core::State::Packing::Size() :
+				compression == Machine::FAST_COMPRESSION ? Core::State::Packing::Speed() :
+				Core::State::Packing()
+			);
 		}
 
 		void Movie::Stop() throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			emulator.tracker.StopMovie();
 		}
 
@@ -26,7 +26,7 @@
 #define NST_API_MOVIE_H
 
 #include <iosfwd>
-#include "NstApi.hpp"
+#include "NstApiMachine.hpp"
 
 #ifdef NST_PRAGMA_ONCE
 #pragma once
@@ -59,8 +59,7 @@ namespace Nes
 			* @param instance emulator instance
 			*/
 			template<typename T>
-			Movie(T& instance)
-			: Base(instance) {}
+			Movie(T& instance);
 
 			/**
 			* Recording procedure.
@@ -90,9 +89,10 @@ namespace Nes
 			*
 			* @param stream stream to record movie to
 			* @param how CLEAN to erase any previous content, APPEND to keep content, default is CLEAN
+			* @param compression compression of the recorded states, default is USE_COMPRESSION
 			* @return result code
 			*/
-			Result Record(std::iostream& stream,How how=CLEAN) throw();
+			Result Record(std::iostream& stream,How how=CLEAN,Machine::Compression compression=Machine::USE_COMPRESSION) throw();
 
 			/**
 			* Stops movie.
@@ -167,9 +167,20 @@ namespace Nes
 			/**
 			* Movie event callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static EventCaller eventCallback;
+			EventCaller& eventCallback;
+
+			/**
+			* Callback storage of an emulator instance.
+			*
+			* Used internally by the core.
+			*/
+			struct Callbacks;
+
+		private:
+
+			static Callbacks& GetCallbacks(Core::Machine&) throw();
 		};
 
 		/**
@@ -185,6 +196,18 @@ namespace Nes
 					function( userdata, event, result );
 			}
 		};
+
+		struct Movie::Callbacks
+		{
+			EventCaller eventCallback;
+		};
+
+		template<typename T>
+		Movie::Movie(T& instance)
+		:
+		Base          (instance),
+		eventCallback (GetCallbacks(emulator).eventCallback)
+		{}
 	}
 }
 
@@ -31,12 +31,15 @@ namespace Nes
 {
 	namespace Api
 	{
+		Nsf::Callbacks& Nsf::GetCallbacks(Core::Machine& machine) throw()
+		{
+			return machine.callbacks.nsf;
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("s", on)
 		#endif
 
-		Nsf::EventCaller Nsf::eventCallback;
-
 		const char* Nsf::GetName() const throw()
 		{
 			if (emulator.Is(Machine::SOUND))
@@ -127,6 +130,8 @@ namespace Nes
 
 		Result Nsf::SelectSong(uint song) throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			if (emulator.Is(Machine::SOUND))
 				return static_cast<Core::Nsf*>(emulator.image)->SelectSong( song );
 
@@ -135,6 +140,8 @@ namespace Nes
 
 		Result Nsf::PlaySong() throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			if (emulator.Is(Machine::SOUND))
 				return static_cast<Core::Nsf*>(emulator.image)->PlaySong();
 
@@ -143,6 +150,8 @@ namespace Nes
 
 		Result Nsf::StopSong() throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			if (emulator.Is(Machine::SOUND))
 				return static_cast<Core::Nsf*>(emulator.image)->StopSong();
 
@@ -151,6 +160,8 @@ namespace Nes
 
 		Result Nsf::SelectNextSong() throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			if (emulator.Is(Machine::SOUND))
 			{
 				return static_cast<Core::Nsf*>(emulator.image)->SelectSong
@@ -164,6 +175,8 @@ namespace Nes
 
 		Result Nsf::SelectPrevSong() throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			if (emulator.Is(Machine::SOUND))
 			{
 				return static_cast<Core::Nsf*>(emulator.image)->SelectSong
@@ -58,8 +58,7 @@ namespace Nes
 			* @param instance emulator instance
 			*/
 			template<typename T>
-			Nsf(T& instance)
-			: Base(instance) {}
+			Nsf(T& instance);
 
 			enum
 			{
@@ -258,9 +257,20 @@ namespace Nes
 			/**
 			* Event callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static EventCaller eventCallback;
+			EventCaller& eventCallback;
+
+			/**
+			* Callback storage of an emulator instance.
+			*
+			* Used internally by the core.
+			*/
+			struct Callbacks;
+
+		private:
+
+			static Callbacks& GetCallbacks(Core::Machine&) throw();
 		};
 
 		/**
@@ -276,6 +286,18 @@ namespace Nes
 					function( userdata, event );
 			}
 		};
+
+		struct Nsf::Callbacks
+		{
+			EventCaller eventCallback;
+		};
+
+		template<typename T>
+		Nsf::Nsf(T& instance)
+		:
+		Base          (instance),
+		eventCallback (GetCallbacks(emulator).eventCallback)
+		{}
 	}
 }
 
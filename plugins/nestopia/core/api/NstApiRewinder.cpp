@@ -31,14 +31,19 @@ namespace Nes
 {
 	namespace Api
 	{
+		Rewinder::Callbacks& Rewinder::GetCallbacks(Core::Machine& machine) throw()
+		{
+			return machine.callbacks.rewinder;
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("s", on)
 		#endif
 
-		Rewinder::StateCaller Rewinder::stateCallback;
-
 		Result Rewinder::Enable(bool enable) throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			try
 			{
 				return emulator.tracker.EnableRewinder( enable ? &emulator : NULL );
@@ -72,6 +77,25 @@ namespace Nes
 			emulator.tracker.EnableRewinderSound( enable );
 		}
 
+		Result Rewinder::SetMemory(ulong bytes) throw()
+		{
+			if (!bytes || bytes > Core::SIZE_1024K * 1024UL)
+				return RESULT_ERR_INVALID_PARAM;
+
+			if (bytes == emulator.tracker.GetRewinderMemory())
+				return RESULT_NOP;
+
+			Core::Callbacks::Scope scope( emulator.callbacks );
+			emulator.tracker.SetRewinderMemory( bytes );
+
+			return RESULT_OK;
+		}
+
+		ulong Rewinder::GetMemory() const throw()
+		{
+			return emulator.tracker.GetRewinderMemory();
+		}
+
 		Rewinder::Direction Rewinder::GetDirection() const throw()
 		{
 			return emulator.tracker.IsRewinding() ? BACKWARD : FORWARD;
@@ -79,6 +103,8 @@ namespace Nes
 
 		Result Rewinder::SetDirection(Direction dir) throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			if (emulator.Is(Machine::GAME,Machine::ON))
 			{
 				if (dir == BACKWARD)
@@ -92,6 +118,8 @@ namespace Nes
 
 		void Rewinder::Reset() throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			if (emulator.Is(Machine::GAME,Machine::ON))
 				emulator.tracker.ResetRewinder();
 		}
@@ -58,8 +58,7 @@ namespace Nes
 			* @param instance emulator instance
 			*/
 			template<typename T>
-			Rewinder(T& instance)
-			: Base(instance) {}
+			Rewinder(T& instance);
 
 			/**
 			* Direction.
@@ -110,6 +109,23 @@ namespace Nes
 			*/
 			bool IsSoundEnabled() const throw();
 
+			/**
+			* Sets the amount of memory to keep the rewind history in. The
+			* history goes back as far as fits, up to an hour. Changing it
+			* clears the history. The default is 4 MB.
+			*
+			* @param bytes number of bytes
+			* @return result code
+			*/
+			Result SetMemory(ulong bytes) throw();
+
+			/**
+			* Returns the amount of memory the rewind history is kept in.
+			*
+			* @return number of bytes
+			*/
+			ulong GetMemory() const throw();
+
 			/**
 			* Sets direction.
 			*
@@ -160,9 +176,20 @@ namespace Nes
 			/**
 			* Rewinder state callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static StateCaller stateCallback;
+			StateCaller& stateCallback;
+
+			/**
+			* Callback storage of an emulator instance.
+			*
+			* Used internally by the core.
+			*/
+			struct Callbacks;
+
+		private:
+
+			static Callbacks& GetCallbacks(Core::Machine&) throw();
 		};
 
 		/**
@@ -178,6 +205,18 @@ namespace Nes
 					function( userdata, state );
 			}
 		};
+
+		struct Rewinder::Callbacks
+		{
+			StateCaller stateCallback;
+		};
+
+		template<typename T>
+		Rewinder::Rewinder(T& instance)
+		:
+		Base          (instance),
+		stateCallback (GetCallbacks(emulator).stateCallback)
+		{}
 	}
 }
 
@@ -31,15 +31,6 @@ namespace Nes
 	#pragma optimize("s", on)
 	#endif
 
-	namespace Core
-	{
-		namespace Sound
-		{
-			Output::Locker Output::lockCallback;
-			Output::Unlocker Output::unlockCallback;
-		}
-	}
-
 	namespace Api
 	{
 		NST_COMPILE_ASSERT
@@ -50,9 +50,6 @@ namespace Nes
 			*/
 			class Output
 			{
-				struct Locker;
-				struct Unlocker;
-
 			public:
 
 				enum
@@ -110,45 +107,45 @@ namespace Nes
 				typedef void (NST_CALLBACK *UnlockCallback) (void* userData,Output& output);
 
 				/**
-				* Sound lock callback manager.
+				* Sound lock callback invoker.
 				*
-				* Static object used for adding the user defined callback.
+				* Used internally by the core.
 				*/
-				static Locker lockCallback;
+				struct Locker : UserCallback<LockCallback>
+				{
+					bool operator () (Output& output) const
+					{
+						return (!function || function( userdata, output ));
+					}
+				};
 
 				/**
-				* Sound unlock callback manager.
+				* Sound unlock callback invoker.
 				*
-				* Static object used for adding the user defined callback.
+				* Used internally by the core.
 				*/
-				static Unlocker unlockCallback;
-			};
-
-			/**
-			* Sound lock callback invoker.
-			*
-			* Used internally by the core.
-			*/
-			struct Output::Locker : UserCallback<Output::LockCallback>
-			{
-				bool operator () (Output& output) const
+				struct Unlocker : UserCallback<UnlockCallback>
 				{
-					return (!function || function( userdata, output ));
-				}
-			};
+					void operator () (Output& output) const
+					{
+						if (function)
+							function( userdata, output );
+					}
+				};
 
-			/**
-			* Sound unlock callback invoker.
-			*
-			* Used internally by the core.
-			*/
-			struct Output::Unlocker : UserCallback<Output::UnlockCallback>
-			{
-				void operator () (Output& output) const
-				{
-					if (function)
-						function( userdata, output );
-				}
+				/**
+				* Sound lock callback manager.
+				*
+				* Used for adding the user defined callback to this output.
+				*/
+				Locker lockCallback;
+
+				/**
+				* Sound unlock callback manager.
+				*
+				* Used for adding the user defined callback to this output.
+				*/
+				Unlocker unlockCallback;
 			};
 		}
 	}
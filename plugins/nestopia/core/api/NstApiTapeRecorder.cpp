@@ -32,12 +32,15 @@ namespace Nes
 {
 	namespace Api
 	{
+		TapeRecorder::Callbacks& TapeRecorder::GetCallbacks(Core::Machine& machine) throw()
+		{
+			return machine.callbacks.tapeRecorder;
+		}
+
 		#ifdef NST_MSVC_OPTIMIZE
 		#pragma optimize("s", on)
 		#endif
 
-		TapeRecorder::EventCaller TapeRecorder::eventCallback;
-
 		Core::Input::FamilyKeyboard* TapeRecorder::Query() const
 		{
 			if (emulator.expPort->GetType() == Input::FAMILYKEYBOARD)
@@ -80,6 +83,8 @@ namespace Nes
 
 		Result TapeRecorder::Play() throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			if (Core::Input::FamilyKeyboard* const familyKeyboard = Query())
 			{
 				if (emulator.Is(Machine::ON) && !emulator.tracker.IsLocked())
@@ -91,6 +96,8 @@ namespace Nes
 
 		Result TapeRecorder::Record() throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			if (Core::Input::FamilyKeyboard* const familyKeyboard = Query())
 			{
 				if (emulator.Is(Machine::ON) && !emulator.tracker.IsLocked())
@@ -102,6 +109,8 @@ namespace Nes
 
 		Result TapeRecorder::Stop() throw()
 		{
+			Core::Callbacks::Scope scope( emulator.callbacks );
+
 			if (Core::Input::FamilyKeyboard* const familyKeyboard = Query())
 			{
 				if (familyKeyboard->IsTapePlaying() || familyKeyboard->IsTapeRecording())
@@ -68,8 +68,7 @@ namespace Nes
 			* @param instance emulator instance
 			*/
 			template<typename T>
-			TapeRecorder(T& instance)
-			: Base(instance) {}
+			TapeRecorder(T& instance);
 
 			/**
 			* Checks if tape is playing.
@@ -165,9 +164,20 @@ namespace Nes
 			/**
 			* Tape event callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static EventCaller eventCallback;
+			EventCaller& eventCallback;
+
+			/**
+			* Callback storage of an emulator instance.
+			*
+			* Used internally by the core.
+			*/
+			struct Callbacks;
+
+		private:
+
+			static Callbacks& GetCallbacks(Core::Machine&) throw();
 		};
 
 		/**
@@ -183,6 +193,18 @@ namespace Nes
 					function( userdata, event );
 			}
 		};
+
+		struct TapeRecorder::Callbacks
+		{
+			EventCaller eventCallback;
+		};
+
+		template<typename T>
+		TapeRecorder::TapeRecorder(T& instance)
+		:
+		Base          (instance),
+		eventCallback (GetCallbacks(emulator).eventCallback)
+		{}
 	}
 }
 
@@ -22,16 +22,17 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////
 
+#include "../NstMachine.hpp"
 #include "NstApiUser.hpp"
 
 namespace Nes
 {
 	namespace Api
 	{
-		User::LogCaller      User::logCallback;
-		User::EventCaller    User::eventCallback;
-		User::QuestionCaller User::questionCallback;
-		User::FileIoCaller   User::fileIoCallback;
+		User::Callbacks& User::GetCallbacks(Core::Machine& machine) throw()
+		{
+			return machine.callbacks.user;
+		}
 
 		const wchar_t* User::File::GetName() const throw()
 		{
@@ -62,8 +62,7 @@ namespace Nes
 			* @param instance emulator instance
 			*/
 			template<typename T>
-			User(T& instance)
-			: Base(instance) {}
+			User(T& instance);
 
 			/**
 			* User questions.
@@ -373,30 +372,41 @@ namespace Nes
 			/**
 			* Logfile callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static LogCaller logCallback;
+			LogCaller& logCallback;
 
 			/**
 			* User event callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static EventCaller eventCallback;
+			EventCaller& eventCallback;
 
 			/**
 			* User question callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static QuestionCaller questionCallback;
+			QuestionCaller& questionCallback;
 
 			/**
 			* File IO callback manager.
 			*
-			* Static object used for adding the user defined callback.
+			* Bound to the emulator instance this interface was created for.
 			*/
-			static FileIoCaller fileIoCallback;
+			FileIoCaller& fileIoCallback;
+
+			/**
+			* Callback storage of an emulator instance.
+			*
+			* Used internally by the core.
+			*/
+			struct Callbacks;
+
+		private:
+
+			static Callbacks& GetCallbacks(Core::Machine&) throw();
 		};
 
 		/**
@@ -459,6 +469,24 @@ namespace Nes
 					function( userdata, file );
 			}
 		};
+
+		struct User::Callbacks
+		{
+			LogCaller logCallback;
+			EventCaller eventCallback;
+			QuestionCaller questionCallback;
+			FileIoCaller fileIoCallback;
+		};
+
+		template<typename T>
+		User::User(T& instance)
+		:
+		Base             (instance),
+		logCallback      (GetCallbacks(emulator).logCallback),
+		eventCallback    (GetCallbacks(emulator).eventCallback),
+		questionCallback (GetCallbacks(emulator).questionCallback),
+		fileIoCallback   (GetCallbacks(emulator).fileIoCallback)
+		{}
 	}
 }
 
@@ -28,15 +28,6 @@
 
 namespace Nes
 {
-	namespace Core
-	{
-		namespace Video
-		{
-			Output::Locker Output::lockCallback;
-			Output::Unlocker Output::unlockCallback;
-		}
-	}
-
 	namespace Api
 	{
 		#ifdef NST_MSVC_OPTIMIZE
@@ -50,9 +50,6 @@ namespace Nes
 			*/
 			class Output
 			{
-				struct Locker;
-				struct Unlocker;
-
 			public:
 
 				enum
@@ -100,45 +97,45 @@ namespace Nes
 				typedef void (NST_CALLBACK *UnlockCallback) (void* userData,Output& output);
 
 				/**
-				* Surface lock callback manager.
+				* Surface lock callback invoker.
 				*
-				* Static object used for adding the user defined callback.
+				* Used internally by the core.
 				*/
-				static Locker lockCallback;
+				struct Locker : UserCallback<LockCallback>
+				{
+					bool operator () (Output& output) const
+					{
+						return (!function || function( userdata, output )) && output.pixels && output.pitch;
+					}
+				};
 
 				/**
-				* Surface unlock callback manager.
+				* Surface unlock callback invoker.
 				*
-				* Static object used for adding the user defined callback.
+				* Used internally by the core.
 				*/
-				static Unlocker unlockCallback;
-			};
-
-			/**
-			* Surface lock callback invoker.
-			*
-			* Used internally by the core.
-			*/
-			struct Output::Locker : UserCallback<Output::LockCallback>
-			{
-				bool operator () (Output& output) const
+				struct Unlocker : UserCallback<UnlockCallback>
 				{
-					return (!function || function( userdata, output )) && output.pixels && output.pitch;
-				}
-			};
+					void operator () (Output& output) const
+					{
+						if (function)
+							function( userdata, output );
+					}
+				};
 
-			/**
-			* Surface unlock callback invoker.
-			*
-			* Used internally by the core.
-			*/
-			struct Output::Unlocker : UserCallback<Output::UnlockCallback>
-			{
-				void operator () (Output& output) const
-				{
-					if (function)
-						function( userdata, output );
-				}
+				/**
+				* Surface lock callback manager.
+				*
+				* Used for adding the user defined callback to this output.
+				*/
+				Locker lockCallback;
+
+				/**
+				* Surface unlock callback manager.
+				*
+				* Used for adding the user defined callback to this output.
+				*/
+				Unlocker unlockCallback;
 			};
 		}
 	}
@@ -617,7 +614,8 @@ namespace Nes
 					Mask mask;
 
 					/**
-					* Bits per pixel.
+					* Bits per pixel. 16 or 32, or 24 with FILTER_NONE for
+					* packed pixels stored least significant byte first.
 					*/
 					uint count;
 				};
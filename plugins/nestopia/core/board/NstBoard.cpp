@@ -388,6 +388,7 @@ namespace Nes
 				cpu.Map( 0xA000, 0xBFFF ).Set( this, &Board::Peek_Prg_A, &Board::Poke_Nop );
 				cpu.Map( 0xC000, 0xDFFF ).Set( this, &Board::Peek_Prg_C, &Board::Poke_Nop );
 				cpu.Map( 0xE000, 0xFFFF ).Set( this, &Board::Peek_Prg_E, &Board::Poke_Nop );
+				cpu.Map( 0x8000, 0xFFFF ).Bind( prg.Banks(), SIZE_8K );
 
 				if (hard)
 				{
@@ -68,7 +68,7 @@ namespace Nes
 					Controllers::BandaiHyperShot& bandaiHyperShot = input->bandaiHyperShot;
 					input = NULL;
 
-					if (Controllers::BandaiHyperShot::callback( bandaiHyperShot ))
+					if (bandaiHyperShot.callback( bandaiHyperShot ))
 					{
 						fire = (bandaiHyperShot.fire ? 0x10 : 0x00);
 						move = (bandaiHyperShot.move ? 0x02 : 0x00);
@@ -87,7 +87,7 @@ namespace Nes
 						Controllers::CrazyClimber& crazy = input->crazyClimber;
 						input = NULL;
 
-						if (Controllers::CrazyClimber::callback( crazy ))
+						if (crazy.callback( crazy ))
 						{
 							state[LEFT] = crazy.left;
 							state[RIGHT] = crazy.right;
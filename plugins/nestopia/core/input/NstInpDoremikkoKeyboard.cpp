@@ -83,7 +83,7 @@ namespace Nes
 
 					if (input)
 					{
-						Controllers::DoremikkoKeyboard::callback( input->doremikkoKeyboard, part, port );
+						input->doremikkoKeyboard.callback( input->doremikkoKeyboard, part, port );
 						return input->doremikkoKeyboard.keys & 0x1E;
 					}
 				}
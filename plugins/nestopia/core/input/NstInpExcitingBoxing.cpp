@@ -59,7 +59,7 @@ namespace Nes
 			{
 				if (input)
 				{
-					Controllers::ExcitingBoxing::callback( input->excitingBoxing, data & 0x2 );
+					input->excitingBoxing.callback( input->excitingBoxing, data & 0x2 );
 					state = ~input->excitingBoxing.buttons & 0x1E;
 				}
 				else
@@ -27,7 +27,7 @@
 #include "../NstCpu.hpp"
 #include "../NstHook.hpp"
 #include "../NstFile.hpp"
-#include "../api/NstApiTapeRecorder.hpp"
+#include "../NstCallbacks.hpp"
 
 namespace Nes
 {
@@ -415,7 +415,7 @@ namespace Nes
 
 				cpu.AddHook( Hook(this,&DataRecorder::Hook_Tape) );
 
-				Api::TapeRecorder::eventCallback( status == PLAYING ? Api::TapeRecorder::EVENT_PLAYING : Api::TapeRecorder::EVENT_RECORDING );
+				Callbacks::Current().tapeRecorder.eventCallback( status == PLAYING ? Api::TapeRecorder::EVENT_PLAYING : Api::TapeRecorder::EVENT_RECORDING );
 			}
 
 			NST_NO_INLINE Result FamilyKeyboard::DataRecorder::Stop(const bool removeHook)
@@ -433,7 +433,7 @@ namespace Nes
 				out = 0;
 				pos = 0;
 
-				Api::TapeRecorder::eventCallback( Api::TapeRecorder::EVENT_STOPPED );
+				Callbacks::Current().tapeRecorder.eventCallback( Api::TapeRecorder::EVENT_STOPPED );
 
 				return RESULT_OK;
 			}
@@ -475,7 +475,7 @@ namespace Nes
 				}
 				else if (input && scan < 9)
 				{
-					Controllers::FamilyKeyboard::callback( input->familyKeyboard, scan, mode );
+					input->familyKeyboard.callback( input->familyKeyboard, scan, mode );
 					return ~uint(input->familyKeyboard.parts[scan]) & 0x1E;
 				}
 				else
@@ -67,7 +67,7 @@ namespace Nes
 				Controllers::FamilyTrainer& trainer = input->familyTrainer;
 				input = NULL;
 
-				if (Controllers::FamilyTrainer::callback( trainer ))
+				if (trainer.callback( trainer ))
 				{
 					static const word lut[Controllers::FamilyTrainer::NUM_SIDE_A_BUTTONS] =
 					{
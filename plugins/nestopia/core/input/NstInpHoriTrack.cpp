@@ -92,7 +92,7 @@ namespace Nes
 						Controllers::HoriTrack& horiTrack = input->horiTrack;
 						input = NULL;
 
-						if (Controllers::HoriTrack::callback( horiTrack ))
+						if (horiTrack.callback( horiTrack ))
 						{
 							dword bits = (horiTrack.buttons & 0xFF) | CONNECTED;
 
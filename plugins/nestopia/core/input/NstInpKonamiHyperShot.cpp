@@ -69,7 +69,7 @@ namespace Nes
 
 				if (prev > strobe && input)
 				{
-					Controllers::KonamiHyperShot::callback( input->konamiHyperShot );
+					input->konamiHyperShot.callback( input->konamiHyperShot );
 					state = input->konamiHyperShot.buttons & 0x1E;
 					input = NULL;
 				}
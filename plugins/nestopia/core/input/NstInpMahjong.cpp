@@ -61,7 +61,7 @@ namespace Nes
 
 				if (data && input)
 				{
-					Controllers::Mahjong::callback( input->mahjong, data );
+					input->mahjong.callback( input->mahjong, data );
 					stream = input->mahjong.buttons << 1;
 				}
 				else
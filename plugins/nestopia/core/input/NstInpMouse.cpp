@@ -92,7 +92,7 @@ namespace Nes
 						Controllers::Mouse& mouse = input->mouse;
 						input = NULL;
 
-						if (Controllers::Mouse::callback( mouse ))
+						if (mouse.callback( mouse ))
 						{
 							data = 0x00;
 
@@ -77,7 +77,7 @@ namespace Nes
 						Controllers::OekaKidsTablet& tablet = input->oekaKidsTablet;
 						input = NULL;
 
-						if (Controllers::OekaKidsTablet::callback( tablet ))
+						if (tablet.callback( tablet ))
 						{
 							if (tablet.x <= 255 && tablet.y <= 239)
 							{
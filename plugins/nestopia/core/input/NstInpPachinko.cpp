@@ -92,7 +92,7 @@ namespace Nes
 						Controllers::Pachinko& pachinko = input->pachinko;
 						input = NULL;
 
-						if (Controllers::Pachinko::callback( pachinko ))
+						if (pachinko.callback( pachinko ))
 						{
 							uint throttle = Clamp<-64,+63>(pachinko.throttle) + 192;
 
@@ -32,7 +32,7 @@ namespace Nes
 	{
 		namespace Input
 		{
-			uint Pad::mic;
+			thread_local uint Pad::mic;
 
 			#ifdef NST_MSVC_OPTIMIZE
 			#pragma optimize("s", on)
@@ -99,7 +99,7 @@ namespace Nes
 					Controllers::Pad& pad = input->pad[type - Api::Input::PAD1];
 					input = NULL;
 
-					if (Controllers::Pad::callback( pad, type - Api::Input::PAD1 ))
+					if (pad.callback( pad, type - Api::Input::PAD1 ))
 					{
 						uint buttons = pad.buttons;
 
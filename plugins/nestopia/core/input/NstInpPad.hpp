@@ -55,7 +55,9 @@ namespace Nes
 				uint stream;
 				uint state;
 
-				static uint mic;
+				// shared by the pads of the frame being run on this thread,
+				// reset in BeginFrame
+				static thread_local uint mic;
 			};
 		}
 	}
@@ -97,7 +97,7 @@ namespace Nes
 						Controllers::Paddle& paddle = input->paddle;
 						input = NULL;
 
-						if (Controllers::Paddle::callback( paddle ))
+						if (paddle.callback( paddle ))
 						{
 							data = 0xFF - ((82 + 172 * (Clamp<32,176>(paddle.x) - 32U) / 144) & 0xFF);
 
@@ -69,7 +69,7 @@ namespace Nes
 				{
 					if (input)
 					{
-						Controllers::PartyTap::callback( input->partyTap );
+						input->partyTap.callback( input->partyTap );
 						state = input->partyTap.units;
 						input = NULL;
 					}
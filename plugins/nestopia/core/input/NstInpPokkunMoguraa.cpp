@@ -59,7 +59,7 @@ namespace Nes
 			{
 				if (input)
 				{
-					Controllers::PokkunMoguraa::callback( input->pokkunMoguraa, ~data & 0x7 );
+					input->pokkunMoguraa.callback( input->pokkunMoguraa, ~data & 0x7 );
 					state = ~input->pokkunMoguraa.buttons & 0x1E;
 				}
 				else
@@ -118,7 +118,7 @@ namespace Nes
 				Controllers::PowerGlove& glove = input->powerGlove;
 				input = NULL;
 
-				if (Controllers::PowerGlove::callback( glove ))
+				if (glove.callback( glove ))
 				{
 					buffer[1] = (glove.x - 128U) & 0xFF;
 					buffer[2] = (128U - glove.y) & 0xFF;
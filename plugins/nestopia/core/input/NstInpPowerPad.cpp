@@ -85,7 +85,7 @@ namespace Nes
 						Controllers::PowerPad& power = input->powerPad;
 						input = NULL;
 
-						if (Controllers::PowerPad::callback( power ))
+						if (power.callback( power ))
 						{
 							static const dword lut[Controllers::PowerPad::NUM_SIDE_A_BUTTONS] =
 							{
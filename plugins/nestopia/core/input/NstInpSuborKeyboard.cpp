@@ -94,7 +94,7 @@ namespace Nes
 				}
 				else if (input && scan < 10)
 				{
-					Controllers::SuborKeyboard::callback( input->suborKeyboard, scan, mode );
+					input->suborKeyboard.callback( input->suborKeyboard, scan, mode );
 					return ~uint(input->suborKeyboard.parts[scan]) & 0x1E;
 				}
 				else
@@ -67,7 +67,7 @@ namespace Nes
 			{
 				if (controllers)
 				{
-					Controllers::TopRider::callback( controllers->topRider );
+					controllers->topRider.callback( controllers->topRider );
 
 					uint data = controllers->topRider.buttons;
 
@@ -169,7 +169,7 @@ namespace Nes
 					Controllers::Zapper& zapper = input->zapper;
 					input = NULL;
 
-					if (Controllers::Zapper::callback( zapper ))
+					if (zapper.callback( zapper ))
 					{
 						fire = (zapper.fire ? arcade ? 0x80 : 0x10 : 0x00);
 
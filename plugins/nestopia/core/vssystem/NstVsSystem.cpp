@@ -231,7 +231,7 @@ namespace Nes
 			{
 				if (input)
 				{
-					Input::Controllers::VsSystem::callback( input->vsSystem );
+					input->vsSystem.callback( input->vsSystem );
 
 					if (input->vsSystem.insertCoin & COIN)
 					{
@@ -1357,12 +1357,15 @@ namespace Nes
 			}
 		};
 
-		void Cartridge::VsSystem::InputMapper::Begin(const Api::Input input,Input::Controllers* const controllers)
+		void Cartridge::VsSystem::InputMapper::Begin(const Api::Input input,Input::Controllers* const c)
 		{
-			Input::Controllers::Pad::callback.Get( userCallback, userData );
+			controllers = c;
 
 			if (controllers)
 			{
+				for (uint i=0; i < 4; ++i)
+					controllers->pad[i].callback.Get( userCallback[i], userData[i] );
+
 				uint ports[2];
 
 				for (uint i=0; i < 2; ++i)
@@ -1370,18 +1373,25 @@ namespace Nes
 					ports[i] = input.GetConnectedController(i) - Api::Input::PAD1;
 
 					if (ports[i] < 4)
-						Input::Controllers::Pad::callback( controllers->pad[ports[i]], ports[i] );
+						controllers->pad[ports[i]].callback( controllers->pad[ports[i]], ports[i] );
 				}
 
-				Input::Controllers::Pad::callback.Set( NULL, NULL );
+				for (uint i=0; i < 4; ++i)
+					controllers->pad[i].callback.Set( NULL, NULL );
 
 				Fix( controllers->pad, ports );
 			}
 		}
 
-		void Cartridge::VsSystem::InputMapper::End() const
+		void Cartridge::VsSystem::InputMapper::End()
 		{
-			Input::Controllers::Pad::callback.Set( userCallback, userData );
+			if (controllers)
+			{
+				for (uint i=0; i < 4; ++i)
+					controllers->pad[i].callback.Set( userCallback[i], userData[i] );
+
+				controllers = NULL;
+			}
 		}
 
 		#ifdef NST_MSVC_OPTIMIZE
@@ -137,8 +137,9 @@ namespace Nes
 
 				virtual void Fix(Pad (&)[4],const uint (&)[2]) const = 0;
 
-				void* userData;
-				Pad::PollCallback userCallback;
+				Input::Controllers* controllers;
+				void* userData[4];
+				Pad::PollCallback userCallback[4];
 
 				struct Type1;
 				struct Type2;
@@ -159,10 +160,14 @@ namespace Nes
 				};
 
 				static InputMapper* Create(Type);
+
+				InputMapper()
+				: controllers(NULL) {}
+
 				virtual ~InputMapper() {}
 
 				void Begin(const Api::Input,Input::Controllers*);
-				void End() const;
+				void End();
 			};
 
 			InputMapper* const inputMapper;
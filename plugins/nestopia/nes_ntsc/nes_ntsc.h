@@ -5,6 +5,7 @@
 #define NES_NTSC_H
 
 #include "nes_ntsc_config.h"
+#include <limits.h>
 
 #ifdef __cplusplus
 	extern "C" {
@@ -107,7 +108,12 @@ statement in a block (unless you're using C++). */
 
 /* private */
 enum { nes_ntsc_entry_size = 128 };
-typedef unsigned long nes_ntsc_rgb_t;
+/* packed rgb only needs 32 bits; anything wider just doubles the table */
+#if UINT_MAX >= 0xFFFFFFFF
+	typedef unsigned int  nes_ntsc_rgb_t;
+#else
+	typedef unsigned long nes_ntsc_rgb_t;
+#endif
 struct nes_ntsc_t {
 	nes_ntsc_rgb_t table [nes_ntsc_palette_size] [nes_ntsc_entry_size];
 };
@@ -18,7 +18,9 @@
 
 #include <fstream>
 #include <jemu/plugin.h>
+#include <jemu/ratecontrol.h>
 #include <jemu/ringbuffer.h>
+#include <jemu/triplebuffer.h>
 
 #include "core/NstBase.hpp"
 #include "core/NstMachine.hpp"
@@ -67,7 +69,7 @@ static int nstHeights[2] =
     Nes::Api::Video::Output::HEIGHT
 };
 
-class NestopiaGameCore : public jemu::GameCoreExtension
+class NestopiaGameCore final : public jemu::GameCoreExtension<NestopiaGameCore>
 {
 public:
     NestopiaGameCore (const String& bundle)
@@ -106,7 +108,7 @@ public:
         }
     }
 
-    void releaseGameCoreResources() override
+    void releaseGameCoreResources()
     {
         Nes::Api::Machine machine (*emu);
         // machine.Power(false);
@@ -114,13 +116,52 @@ public:
     }
 
     double getSampleRate() const { return (double) SAMPLERATE; }
+
+    void setOutputSampleRate (double rate)
+    {
+        rateControl.setNominalRatio (rate > 0.0 ? getSampleRate() / rate : 1.0);
+    }
+
+    void setIdleSkip (bool enabled)
+    {
+        Nes::Api::Machine (*emu).EnableIdleSkip (enabled);
+    }
+
     int getNumAudioChannels() const { return 1; }
 
-    uint8_t* getVideoBuffer() const override
+    uint8_t* getVideoBuffer() const
+    {
+        return videoBufferSize > 0 && ! useHostFrames ? videoBuffer.getData() : nullptr;
+    }
+
+    bool setFrameBuffers (const JemuVideoFormat* format, void* const* buffers)
+    {
+        ScopedLock vsl (videoLock);
+
+        if (format == nullptr || buffers == nullptr)
+        {
+            useHostFrames = false;
+            return setPixelFormat (JEMU_PIXEL_FORMAT_XRGB8888);
+        }
+
+        if (format->width != (uint32) width || format->height != (uint32) height)
+            return false;
+        if (std::abs (format->pitch) < width * bytesPerPixel (format->pixel_format))
+            return false;
+        if (! setPixelFormat (format->pixel_format))
+            return false;
+
+        for (int i = 0; i < 3; ++i)
+            hostFrames[i] = buffers[i];
+        hostPitch = format->pitch;
+        frameExchange.reset();
+        useHostFrames = true;
+        return true;
+    }
+
+    int32_t acquireFrame()
     {
-        nesVideo->pixels = (void*) videoBuffer.getData();
-        nesVideo->pitch  = width * 4;
-        return videoBufferSize > 0 ? videoBuffer.getData() : nullptr;
+        return useHostFrames ? frameExchange.acquire() : -1;
     }
 
     uint8_t* videoFrame() const { return getVideoBuffer(); }
@@ -132,7 +173,15 @@ public:
             : Nes::Api::Machine::CLK_PAL_DOT / Nes::Api::Machine::CLK_PAL_VSYNC;  // 50.0069789082
     }
 
-    void prepareGameCore() override
+    double getFrameRate() const
+    {
+        Nes::Api::Machine machine (*emu);
+        return (machine.GetMode() == Nes::Api::Machine::NTSC)
+            ? (double) Nes::Api::Machine::CLK_NTSC_DOT / (double) Nes::Api::Machine::CLK_NTSC_VSYNC
+            : (double) Nes::Api::Machine::CLK_PAL_DOT / (double) Nes::Api::Machine::CLK_PAL_VSYNC;
+    }
+
+    void prepareGameCore()
     {
         Nes::Api::Machine machine (*emu);
         Nes::Api::Cartridge::Database database (*emu);
@@ -170,16 +219,11 @@ public:
         DBG("[emu] nestopia: setup");
     }
 
-    void readAudio (float* buffer, int numSamples) override
+    void readAudio (float* buffer, int numSamples)
     {
-        for (int f = 0; f < numSamples; ++f)
-            buffer[f] = 0.f;
-        if (audioRingBuffer.readSpace() < static_cast<uint32> (sizeof(uint16) * numSamples))
-            return;
-        audioRingBuffer.read (static_cast<uint32> (numSamples) * sizeof (uint16),
-            soundReadBuffer.getData());
-        AudioDataConverters::convertFormatToFloat (AudioDataConverters::int16LE,
-            soundReadBuffer.getData(), buffer, numSamples);
+        // resample straight out of the ring, nudging the rate so the ring
+        // hovers around half full whatever clock the host paces frames with
+        rateControl.process (audioRingBuffer, buffer, numSamples);
     }
 
     void setCheat (const String& code, const bool enabled)
@@ -215,7 +259,7 @@ public:
         // }
     }
 
-    bool loadRom (const char* romPath) override
+    bool loadRom (const char* romPath)
     {
         DBG("[emu] nestopia: loading rom");
         DBG("[emu] nestopia: " << romPath);
@@ -240,10 +284,10 @@ public:
         // [self setRomPath:path];
 
         // void *userData = (__bridge void *)self;
-        // Nes::Api::User::fileIoCallback.Set(doFileIO, userData);
-        // Nes::Api::User::logCallback.Set(doLog, userData);
-        // Nes::Api::Machine::eventCallback.Set(doEvent, userData);
-        // Nes::Api::User::questionCallback.Set(doQuestion, userData);
+        // Nes::Api::User (*emu).fileIoCallback.Set(doFileIO, userData);
+        // Nes::Api::User (*emu).logCallback.Set(doLog, userData);
+        // Nes::Api::Machine (*emu).eventCallback.Set(doEvent, userData);
+        // Nes::Api::User (*emu).questionCallback.Set(doQuestion, userData);
         
         Nes::Api::Fds fds (*emu);
         const String biosFilePath = "";
@@ -291,13 +335,57 @@ public:
         return true;
     }
 
-    void tick() override
+    void tick()
     { 
         processFrame();
     }
+
+    uint32_t runFrames (uint32_t count, const JemuInputFrame* inputs, uint32_t flags)
+    {
+        ScopedLock asl (audioLock);
+        ScopedLock vsl (videoLock);
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            if (inputs != nullptr)
+                setInputFrame (inputs[i]);
+
+            const bool lastFrame = i + 1 == count;
+            executeFrame (lastFrame || (flags & JEMU_RUN_SKIP_VIDEO) == 0,
+                          lastFrame || (flags & JEMU_RUN_SKIP_AUDIO) == 0);
+        }
+
+        return count;
+    }
+
+    uint32_t getStateSize()
+    {
+        ScopedLock asl (audioLock);
+        ScopedLock vsl (videoLock);
+        Nes::Api::Machine machine (*emu);
+        Nes::ulong size = 0;
+        return NES_SUCCEEDED (machine.GetStateSize (size)) ? (uint32_t) size : 0;
+    }
+
+    uint32_t saveStateInto (void* buffer, uint32_t size)
+    {
+        ScopedLock asl (audioLock);
+        ScopedLock vsl (videoLock);
+        Nes::Api::Machine machine (*emu);
+        Nes::ulong written = 0;
+        return NES_SUCCEEDED (machine.SaveState (buffer, size, written)) ? (uint32_t) written : 0;
+    }
+
+    bool loadStateFrom (const void* buffer, uint32_t size)
+    {
+        ScopedLock asl (audioLock);
+        ScopedLock vsl (videoLock);
+        Nes::Api::Machine machine (*emu);
+        return NES_SUCCEEDED (machine.LoadState (buffer, size));
+    }
         
 
-    void buttonPress (const uint32_t button, const bool pressed) override
+    void buttonPress (const uint32_t button, const bool pressed)
     { 
         return pressed ? buttonPressed (button) : buttonReleased (button);
     }
@@ -310,10 +398,15 @@ private:
     std::unique_ptr<Nes::Api::Emulator> emu;
     CriticalSection audioLock, videoLock;
     HashMap<String, bool> cheatMap;
-    HeapBlock<uint16> soundBuffer, soundReadBuffer;
+    HeapBlock<uint16> soundBuffer;
     jemu::RingBuffer audioRingBuffer;
+    jemu::DynamicRateControl rateControl;
     HeapBlock<uint8> videoBuffer;
     int videoBufferSize = 0;
+    void* hostFrames [3] = { nullptr, nullptr, nullptr };
+    int32 hostPitch = 0;
+    bool useHostFrames = false;
+    jemu::TripleBuffer frameExchange;
     uint32 bufFrameSize = 0;
     int width = 0;
     int height = 0;
@@ -341,8 +434,8 @@ private:
 
         bufFrameSize = SAMPLERATE / getFrameInterval();
         soundBuffer.allocate (bufFrameSize * getNumAudioChannels(), true);
-        soundReadBuffer.allocate (bufFrameSize * getNumAudioChannels(), true);
         audioRingBuffer.resize (5 * bufFrameSize * getNumAudioChannels() * sizeof (uint16));
+        rateControl.reset();
         
         nesSound->samples[0]  = soundBuffer.getData();
         nesSound->length[0]   = bufFrameSize;
@@ -398,15 +491,128 @@ private:
         DBG("[emu] nestopia: loaded video");
     }
 
+    void setInputFrame (const JemuInputFrame& input)
+    {
+        for (int pad = 0; pad < JEMU_INPUT_FRAME_PADS; ++pad)
+        {
+            uint32 buttons = 0;
+            for (int button = 0; button < numElementsInArray (nstControlValues); ++button)
+                if ((input.pads[pad] & (1u << button)) != 0)
+                    buttons |= nstControlValues [button];
+            controls->pad[pad].buttons = buttons;
+        }
+    }
+
     void processFrame()
     {
         ScopedLock asl (audioLock);
         ScopedLock vsl (videoLock);
-        emu->Execute (nesVideo.get(), nesSound.get(), controls.get());
-        const uint32 requiredSize = getNumAudioChannels() * bufFrameSize * sizeof(uint16);
-        if (requiredSize < audioRingBuffer.writeSpace())
-            audioRingBuffer.write ((uint32) getNumAudioChannels() * bufFrameSize * sizeof (uint16),
-                soundBuffer.getData());
+        executeFrame (true, true);
+    }
+
+    /** Emulate one frame, called with audioLock and videoLock held. A frame
+        without video or audio still runs the PPU and APU, Nestopia just
+        skips rendering their output */
+    void executeFrame (const bool renderVideo, const bool renderAudio)
+    {
+        // let the APU render straight into the ring buffer. When the reader
+        // has fallen behind, the frame is rendered into soundBuffer and dropped
+        const uint32 frameSize = getNumAudioChannels() * sizeof (uint16);
+        const uint32 requiredSize = bufFrameSize * frameSize;
+        const auto regions = renderAudio ? audioRingBuffer.writeRegions (requiredSize)
+                                         : jemu::RingBuffer::Regions();
+        const bool haveSpace = renderAudio && regions.total() == requiredSize;
+
+        if (haveSpace)
+        {
+            nesSound->samples[0] = regions.data[0];
+            nesSound->length[0]  = regions.size[0] / frameSize;
+            nesSound->samples[1] = regions.data[1];
+            nesSound->length[1]  = regions.size[1] / frameSize;
+        }
+        else
+        {
+            nesSound->samples[0] = soundBuffer.getData();
+            nesSound->length[0]  = bufFrameSize;
+            nesSound->samples[1] = nullptr;
+            nesSound->length[1]  = 0;
+        }
+
+        if (useHostFrames)
+        {
+            nesVideo->pixels = hostFrames [frameExchange.backIndex()];
+            nesVideo->pitch  = hostPitch;
+        }
+        else
+        {
+            nesVideo->pixels = videoBuffer.getData();
+            nesVideo->pitch  = width * 4;
+        }
+
+        emu->Execute (renderVideo ? nesVideo.get() : nullptr,
+                      renderAudio ? nesSound.get() : nullptr,
+                      controls.get());
+
+        if (renderVideo && useHostFrames)
+            frameExchange.publish();
+        if (haveSpace)
+            audioRingBuffer.commitWrite (requiredSize);
+    }
+
+    static int bytesPerPixel (const uint32 pixelFormat)
+    {
+        switch (pixelFormat)
+        {
+            case JEMU_PIXEL_FORMAT_RGB565: return 2;
+            case JEMU_PIXEL_FORMAT_RGB888: return 3;
+            default: break;
+        }
+
+        return 4;
+    }
+
+    bool setPixelFormat (const uint32 pixelFormat)
+    {
+        Nes::Api::Video video (*emu);
+        Nes::Api::Video::RenderState renderState;
+        if (NES_FAILED (video.GetRenderState (renderState)))
+            return false;
+
+        switch (pixelFormat)
+        {
+            case JEMU_PIXEL_FORMAT_XRGB8888:
+                renderState.bits.count  = 32;
+                renderState.bits.mask.r = 0xFF0000;
+                renderState.bits.mask.g = 0x00FF00;
+                renderState.bits.mask.b = 0x0000FF;
+                break;
+
+            case JEMU_PIXEL_FORMAT_RGB565:
+                renderState.bits.count  = 16;
+                renderState.bits.mask.r = 0xF800;
+                renderState.bits.mask.g = 0x07E0;
+                renderState.bits.mask.b = 0x001F;
+                break;
+
+            case JEMU_PIXEL_FORMAT_XBGR8888:
+                renderState.bits.count  = 32;
+                renderState.bits.mask.r = 0x0000FF;
+                renderState.bits.mask.g = 0x00FF00;
+                renderState.bits.mask.b = 0xFF0000;
+                break;
+
+            case JEMU_PIXEL_FORMAT_RGB888:
+                renderState.bits.count  = 24;
+                renderState.bits.mask.r = 0xFF0000;
+                renderState.bits.mask.g = 0x00FF00;
+                renderState.bits.mask.b = 0x0000FF;
+                break;
+
+            default:
+                return false;
+        }
+
+        return NES_SUCCEEDED (video.SetRenderState (renderState));
     }
 
     void setDisplayMode (const int mode)
@@ -441,4 +647,7 @@ private:
     }
 };
 
-JEMU_REGISTER_PLUGIN(NestopiaGameCore, JEMU_NESTOPIA, { JEMU_GAME_CORE });
+JEMU_REGISTER_PLUGIN(NestopiaGameCore, JEMU_NESTOPIA, { JEMU_GAME_CORE, JEMU_GAME_CORE_TIMING,
+                                                     JEMU_GAME_CORE_AUDIO, JEMU_GAME_CORE_VIDEO,
+                                                     JEMU_GAME_CORE_BATCH, JEMU_GAME_CORE_CAPS,
+                                                     JEMU_GAME_CORE_STATE, JEMU_GAME_CORE_IDLE });
@@ -0,0 +1,470 @@
+/*
+    This file is part of Jemu
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "GameCore.h"
+
+/** Runs many game cores on a work-stealing thread pool.
+
+    Each instance is a task that is queued on exactly one worker at a time,
+    so a core is never stepped by two threads at once. Workers take tasks
+    from their own queue in order and, when that runs dry, steal the
+    longest waiting task from another worker's queue.
+
+    In real-time mode every instance has a frame deadline derived from its
+    frame rate. A step runs all frames that are due (up to maxCatchUpFrames,
+    skipping video on all but the last) and then parks the instance on a
+    timer until its next frame is due. In throughput mode instances are
+    requeued straight away and run as fast as the pool allows.
+
+    Instances can only be added while the engine is stopped. They are held
+    as GameCoreInstance, so each frame step calls straight into the plugin.
+*/
+class Engine
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct InstanceOptions
+    {
+        /** Frames per second, or 0 to use the core's own rate */
+        double frameRate        = 0.0;
+        /** Preferred worker, or -1 to let the pool decide. Instances that
+            share a hint stay on the same worker unless it is stolen from */
+        int affinity            = -1;
+        /** Most frames run in one step before the deadline is re-anchored */
+        int maxCatchUpFrames    = 4;
+        /** JemuRunFlags passed to runFrames for every step */
+        uint32 runFlags         = 0;
+    };
+
+    struct InstanceStats
+    {
+        uint64 frames       = 0;
+        /** Frames the instance is behind its deadline right now */
+        double framesBehind = 0.0;
+        /** How late the last step started, and the worst so far, in ms */
+        double lagMs        = 0.0;
+        double maxLagMs     = 0.0;
+        int worker          = -1;
+    };
+
+    struct Stats
+    {
+        /** Aggregate rate since the previous call to getStats() */
+        double framesPerSecond = 0.0;
+        uint64 totalFrames     = 0;
+        uint64 steals          = 0;
+        std::vector<InstanceStats> instances;
+    };
+
+    /** Creates an engine with numWorkers threads, or one per hardware
+        thread if numWorkers is 0 or less */
+    explicit Engine (int numWorkers = 0)
+    {
+        if (numWorkers <= 0)
+            numWorkers = jmax (1, (int) std::thread::hardware_concurrency());
+        for (int i = 0; i < numWorkers; ++i)
+            workers.emplace_back (new Worker());
+    }
+
+    ~Engine()
+    {
+        stop();
+    }
+
+    int getNumWorkers()   const { return (int) workers.size(); }
+    int getNumInstances() const { return (int) instances.size(); }
+    bool isRunning()      const { return running.load (std::memory_order_acquire); }
+
+    GameCoreInstance* getInstance (const int index) const
+    {
+        return isPositiveAndBelow (index, getNumInstances()) ? instances[index]->core.get() : nullptr;
+    }
+
+    /** Takes ownership of core. Returns its index, or -1 if the engine is
+        running */
+    int addInstance (GameCoreInstance* core)
+    {
+        return addInstance (core, InstanceOptions());
+    }
+
+    int addInstance (GameCoreInstance* core, const InstanceOptions& options)
+    {
+        std::unique_ptr<GameCoreInstance> owned (core);
+        jassert (owned != nullptr);
+        if (owned == nullptr || isRunning())
+            return -1;
+
+        auto* instance = new Instance();
+        instance->options = options;
+        const double rate = options.frameRate > 0.0 ? options.frameRate : owned->getFrameRate();
+        instance->period = std::chrono::duration_cast<Clock::duration> (
+            std::chrono::duration<double> (1.0 / jmax (1.0, rate)));
+        instance->core = std::move (owned);
+        instances.emplace_back (instance);
+        return getNumInstances() - 1;
+    }
+
+    /** Run every instance as fast as possible instead of pacing by deadline */
+    void setThroughputMode (const bool shouldRunFlatOut)
+    {
+        throughput.store (shouldRunFlatOut, std::memory_order_release);
+        wakeAll();
+    }
+
+    bool isThroughputMode() const { return throughput.load (std::memory_order_acquire); }
+
+    void start()
+    {
+        if (isRunning())
+            return;
+
+        const auto now = Clock::now();
+        statsTime = now;
+        statsFrames = 0;
+
+        for (size_t i = 0; i < instances.size(); ++i)
+        {
+            auto& instance = *instances[i];
+            instance.anchor = now;
+            instance.framesSinceAnchor = 0;
+            instance.nextDeadline.store (now.time_since_epoch().count(), std::memory_order_relaxed);
+            workers[preferredWorker (instance, (int) i)]->tasks.push_back ((int) i);
+        }
+
+        running.store (true, std::memory_order_release);
+        for (int w = 0; w < getNumWorkers(); ++w)
+            workers[w]->thread = std::thread ([this, w]() { workerLoop (w); });
+    }
+
+    void stop()
+    {
+        if (! isRunning())
+            return;
+
+        running.store (false, std::memory_order_release);
+        wakeAll();
+
+        for (auto& worker : workers)
+        {
+            if (worker->thread.joinable())
+                worker->thread.join();
+            worker->tasks.clear();
+        }
+
+        timers = TimerQueue();
+        earliestTimer.store (std::numeric_limits<int64>::max(), std::memory_order_relaxed);
+    }
+
+    /** Aggregate and per-instance figures. Safe to call while running */
+    Stats getStats()
+    {
+        Stats stats;
+        const auto now = Clock::now();
+
+        for (const auto& instance : instances)
+        {
+            InstanceStats s;
+            s.frames   = instance->frames.load (std::memory_order_relaxed);
+            s.lagMs    = instance->lagNanos.load (std::memory_order_relaxed) * 1.0e-6;
+            s.maxLagMs = instance->maxLagNanos.load (std::memory_order_relaxed) * 1.0e-6;
+            s.worker   = instance->worker.load (std::memory_order_relaxed);
+
+            if (isRunning() && ! isThroughputMode())
+            {
+                const Clock::duration late (now.time_since_epoch().count()
+                    - instance->nextDeadline.load (std::memory_order_relaxed));
+                if (late.count() > 0)
+                    s.framesBehind = (double) late.count() / (double) instance->period.count();
+            }
+
+            stats.totalFrames += s.frames;
+            stats.instances.push_back (s);
+        }
+
+        const double elapsed = std::chrono::duration<double> (now - statsTime).count();
+        if (elapsed > 0.0)
+            stats.framesPerSecond = (double) (stats.totalFrames - statsFrames) / elapsed;
+        statsTime = now;
+        statsFrames = stats.totalFrames;
+        stats.steals = steals.load (std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    struct Instance
+    {
+        std::unique_ptr<GameCoreInstance> core;
+        InstanceOptions options;
+        Clock::duration period;
+
+        // only touched by the worker currently holding the task
+        Clock::time_point anchor;
+        uint64 framesSinceAnchor = 0;
+
+        std::atomic<uint64> frames { 0 };
+        std::atomic<int64> nextDeadline { 0 };
+        std::atomic<int64> lagNanos { 0 };
+        std::atomic<int64> maxLagNanos { 0 };
+        std::atomic<int> worker { -1 };
+    };
+
+    struct Worker
+    {
+        std::mutex lock;
+        std::deque<int> tasks;
+        std::thread thread;
+        std::minstd_rand random;
+    };
+
+    typedef std::pair<Clock::time_point, int> Timer;
+    typedef std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> TimerQueue;
+
+    std::vector<std::unique_ptr<Instance>> instances;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> running { false };
+    std::atomic<bool> throughput { false };
+    std::atomic<uint64> steals { 0 };
+
+    std::mutex timerLock;
+    std::condition_variable wakeup;
+    TimerQueue timers;
+    std::atomic<int64> earliestTimer { std::numeric_limits<int64>::max() };
+    std::atomic<int> sleepers { 0 };
+
+    Clock::time_point statsTime;
+    uint64 statsFrames = 0;
+
+    int preferredWorker (const Instance& instance, const int fallback) const
+    {
+        const int hint = instance.options.affinity >= 0 ? instance.options.affinity : fallback;
+        return hint % getNumWorkers();
+    }
+
+    void wakeAll()
+    {
+        std::lock_guard<std::mutex> sl (timerLock);
+        wakeup.notify_all();
+    }
+
+    void enqueue (const int worker, const int task)
+    {
+        {
+            std::lock_guard<std::mutex> sl (workers[worker]->lock);
+            workers[worker]->tasks.push_back (task);
+        }
+
+        // a worker counts itself as a sleeper before it checks the queues,
+        // under the queue lock just released, so if none is counted here
+        // any worker about to sleep will find this task
+        if (sleepers.load (std::memory_order_acquire) > 0)
+        {
+            std::lock_guard<std::mutex> sl (timerLock);
+            wakeup.notify_one();
+        }
+    }
+
+    bool popLocal (const int worker, int& task)
+    {
+        auto& self = *workers[worker];
+        std::lock_guard<std::mutex> sl (self.lock);
+        if (self.tasks.empty())
+            return false;
+        task = self.tasks.front();
+        self.tasks.pop_front();
+        return true;
+    }
+
+    bool steal (const int thief, int& task)
+    {
+        // start at a random victim so no single queue gets all the thieves
+        const int count = getNumWorkers();
+        const int start = (int) (workers[thief]->random() % (uint32) count);
+        for (int i = 0; i < count; ++i)
+        {
+            const int index = (start + i) % count;
+            if (index == thief)
+                continue;
+
+            auto& victim = *workers[index];
+            std::lock_guard<std::mutex> sl (victim.lock);
+            if (victim.tasks.empty())
+                continue;
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            steals.fetch_add (1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+    /** Moves instances whose deadline has passed back onto the queues.
+        Returns the time the earliest remaining timer fires */
+    Clock::time_point releaseTimers (const int worker, std::unique_lock<std::mutex>& sl)
+    {
+        const auto now = Clock::now();
+        std::vector<int> due;
+
+        while (! timers.empty() && (timers.top().first <= now || isThroughputMode()))
+        {
+            due.push_back (timers.top().second);
+            timers.pop();
+        }
+
+        const auto next = timers.empty() ? now + std::chrono::milliseconds (100)
+                                         : timers.top().first;
+        updateEarliestTimer();
+        if (! due.empty())
+        {
+            sl.unlock();
+            for (const int task : due)
+                enqueue (preferredWorker (*instances[task], worker), task);
+            sl.lock();
+        }
+
+        return next;
+    }
+
+    void updateEarliestTimer()
+    {
+        earliestTimer.store (timers.empty() ? std::numeric_limits<int64>::max()
+                                            : timers.top().first.time_since_epoch().count(),
+                             std::memory_order_relaxed);
+    }
+
+    void workerLoop (const int worker)
+    {
+        while (isRunning())
+        {
+            // busy workers still hand out expired timers, or a lagging
+            // instance that keeps requeueing itself would starve the rest
+            if (Clock::now().time_since_epoch().count() >= earliestTimer.load (std::memory_order_relaxed))
+            {
+                std::unique_lock<std::mutex> sl (timerLock);
+                releaseTimers (worker, sl);
+            }
+
+            int task = -1;
+            if (popLocal (worker, task) || steal (worker, task))
+            {
+                runInstance (task, worker);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> sl (timerLock);
+            const auto next = releaseTimers (worker, sl);
+            if (! isRunning())
+                break;
+
+            // something may have been queued while the timer lock was free
+            sleepers.fetch_add (1, std::memory_order_seq_cst);
+            bool idle = true;
+            for (auto& other : workers)
+            {
+                std::lock_guard<std::mutex> ol (other->lock);
+                if (! other->tasks.empty())
+                    idle = false;
+            }
+
+            if (idle)
+                wakeup.wait_until (sl, next);
+            sleepers.fetch_sub (1, std::memory_order_relaxed);
+        }
+    }
+
+    void runInstance (const int task, const int worker)
+    {
+        auto& instance = *instances[task];
+        auto& core = *instance.core;
+        const auto now = Clock::now();
+        instance.worker.store (worker, std::memory_order_relaxed);
+
+        if (isThroughputMode())
+        {
+            core.runFrames (1, nullptr, instance.options.runFlags);
+            instance.frames.fetch_add (1, std::memory_order_relaxed);
+            instance.lagNanos.store (0, std::memory_order_relaxed);
+
+            // keep the deadline current so switching back doesn't catch up
+            instance.anchor = Clock::now();
+            instance.framesSinceAnchor = 0;
+            instance.nextDeadline.store (instance.anchor.time_since_epoch().count(),
+                                         std::memory_order_relaxed);
+            enqueue (preferredWorker (instance, worker), task);
+            return;
+        }
+
+        const auto deadline = instance.anchor + instance.period * (int64) instance.framesSinceAnchor;
+        const int64 due = (now - instance.anchor) / instance.period + 1
+                        - (int64) instance.framesSinceAnchor;
+        const int maxFrames = jmax (1, instance.options.maxCatchUpFrames);
+
+        int framesRun = (int) jlimit ((int64) 1, (int64) maxFrames, due);
+        if (due > maxFrames)
+        {
+            // too far behind to catch up, drop frames and start over
+            instance.anchor = now;
+            instance.framesSinceAnchor = 0;
+            framesRun = 1;
+        }
+
+        const uint32 ran = core.runFrames ((uint32) framesRun, nullptr,
+                                           instance.options.runFlags | JEMU_RUN_SKIP_VIDEO);
+        instance.framesSinceAnchor += ran;
+        instance.frames.fetch_add (ran, std::memory_order_relaxed);
+
+        const int64 lag = jmax ((int64) 0, (int64) std::chrono::duration_cast<std::chrono::nanoseconds> (
+            now - deadline).count());
+        instance.lagNanos.store (lag, std::memory_order_relaxed);
+        if (lag > instance.maxLagNanos.load (std::memory_order_relaxed))
+            instance.maxLagNanos.store (lag, std::memory_order_relaxed);
+
+        const auto next = instance.anchor + instance.period * (int64) instance.framesSinceAnchor;
+        instance.nextDeadline.store (next.time_since_epoch().count(), std::memory_order_relaxed);
+
+        if (next <= Clock::now())
+        {
+            enqueue (preferredWorker (instance, worker), task);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> sl (timerLock);
+            timers.push (Timer (next, task));
+            updateEarliestTimer();
+            if (sleepers.load (std::memory_order_relaxed) > 0)
+                wakeup.notify_one();
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Engine)
+};
@@ -0,0 +1,99 @@
+/*
+    This file is part of Jemu
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#pragma once
+
+#include <jemu/plugin.h>
+#include "JuceHeader.h"
+
+/** Pixel data for a frame a game core renders into directly.
+
+    Frames are JEMU_PIXEL_FORMAT_XRGB8888, which JUCE can draw as-is: an
+    Image::RGB with a four byte pixel stride, since the first three bytes
+    of each little endian pixel are PixelRGB's b, g, r. The undefined top
+    byte is skipped, so no alpha pass is needed.
+*/
+class FramePixelData : public ImagePixelData
+{
+public:
+    FramePixelData (const int w, const int h)
+        : ImagePixelData (Image::RGB, w, h),
+          lineStride (w * 4)
+    {
+        pixels.allocate ((size_t) (lineStride * h), true);
+    }
+
+    /** Creates an image backed by a new frame */
+    static Image createImage (const int w, const int h)
+    {
+        return Image (new FramePixelData (w, h));
+    }
+
+    /** Returns the frame memory of an image made by createImage */
+    static void* getFrameData (const Image& image)
+    {
+        if (auto* frame = dynamic_cast<FramePixelData*> (image.getPixelData()))
+            return frame->pixels.getData();
+        return nullptr;
+    }
+
+    /** Fills in a JemuVideoFormat matching an image made by createImage */
+    static JemuVideoFormat getVideoFormat (const Image& image)
+    {
+        JemuVideoFormat format;
+        format.pixel_format = JEMU_PIXEL_FORMAT_XRGB8888;
+        format.width  = (uint32_t) image.getWidth();
+        format.height = (uint32_t) image.getHeight();
+        format.pitch  = image.getWidth() * 4;
+        return format;
+    }
+
+    LowLevelGraphicsContext* createLowLevelContext() override
+    {
+        sendDataChangeMessage();
+        return new LowLevelGraphicsSoftwareRenderer (Image (this));
+    }
+
+    void initialiseBitmapData (Image::BitmapData& bitmap, int x, int y,
+                               Image::BitmapData::ReadWriteMode mode) override
+    {
+        bitmap.data = pixels + x * pixelStride + y * lineStride;
+        bitmap.pixelFormat = pixelFormat;
+        bitmap.lineStride = lineStride;
+        bitmap.pixelStride = pixelStride;
+
+        if (mode != Image::BitmapData::readOnly)
+            sendDataChangeMessage();
+    }
+
+    ImagePixelData::Ptr clone() override
+    {
+        auto* copy = new FramePixelData (width, height);
+        memcpy (copy->pixels, pixels, (size_t) (lineStride * height));
+        return copy;
+    }
+
+    ImageType* createType() const override { return new SoftwareImageType(); }
+
+private:
+    enum { pixelStride = 4 };
+    const int lineStride;
+    HeapBlock<uint8> pixels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FramePixelData)
+};
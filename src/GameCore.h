@@ -32,6 +32,49 @@ public:
     virtual bool load (const char*) =0;
     virtual void readAudio (float*, const int) { }
     virtual uint8_t* getVideoBuffer() const { return nullptr; }
+    virtual double getFrameRate() const { return 60.0; }
+    virtual double getSampleRate() const { return 48000.0; }
+    virtual void setOutputSampleRate (double) { }
+    virtual bool setFrameBuffers (const JemuVideoFormat&, void* const*) { return false; }
+    virtual int acquireFrame() { return -1; }
+
+    /** In-memory save states, see JemuGameCoreState. Cores without them
+        report a size of 0 and fail every save and load */
+    virtual uint32_t getStateSize() { return 0; }
+    virtual uint32_t saveStateInto (void*, uint32_t) { return 0; }
+    virtual bool loadStateFrom (const void*, uint32_t) { return false; }
+
+    /** Skip idle loops, see JemuGameCoreIdle. Ignored by cores without it */
+    virtual void setIdleSkip (bool) { }
+
+    /** Saves a state into block, which is only grown when the state no
+        longer fits, so one block can be reused for every save. Returns the
+        number of bytes written, or 0 on failure */
+    uint32_t saveState (MemoryBlock& block)
+    {
+        uint32_t written = saveStateInto (block.getData(), (uint32_t) block.getSize());
+        if (written == 0)
+        {
+            const uint32_t size = getStateSize();
+            if (size > block.getSize())
+            {
+                block.setSize (size);
+                written = saveStateInto (block.getData(), size);
+            }
+        }
+
+        return written;
+    }
+
+    /** Emulate count frames, see JemuGameCoreBatch. Cores without batching
+        just tick, ignoring inputs and flags */
+    virtual uint32_t runFrames (uint32_t count, const JemuInputFrame* inputs, uint32_t flags)
+    {
+        ignoreUnused (inputs, flags);
+        for (uint32_t i = 0; i < count; ++i)
+            tick();
+        return count;
+    }
     
     inline virtual void buttonPress (const uint32_t button, const bool pressed)
     {
@@ -51,7 +94,12 @@ protected:
     GameCore() { }
 };
 
-class GameCoreInstance : public GameCore
+/** A game core loaded from a plugin.
+
+    Final, so code holding a GameCoreInstance rather than a GameCore calls
+    straight through to the plugin's function tables without a virtual call.
+*/
+class GameCoreInstance final : public GameCore
 {
 public:
     explicit GameCoreInstance (const JemuDescriptor* d, JemuHandle h) 
@@ -68,6 +116,35 @@ public:
         jassert (nullptr != core.reset);
         jassert (nullptr != core.tick);
         jassert (nullptr != core.video_frame);
+
+        memset (&timing, 0, sizeof (JemuGameCoreTiming));
+        if (const void* data = desc.extension (JEMU_GAME_CORE_TIMING))
+            memcpy (&timing, data, sizeof (JemuGameCoreTiming));
+
+        memset (&audio, 0, sizeof (JemuGameCoreAudio));
+        if (const void* data = desc.extension (JEMU_GAME_CORE_AUDIO))
+            memcpy (&audio, data, sizeof (JemuGameCoreAudio));
+
+        memset (&video, 0, sizeof (JemuGameCoreVideo));
+        if (const void* data = desc.extension (JEMU_GAME_CORE_VIDEO))
+            memcpy (&video, data, sizeof (JemuGameCoreVideo));
+
+        memset (&batch, 0, sizeof (JemuGameCoreBatch));
+        if (const void* data = desc.extension (JEMU_GAME_CORE_BATCH))
+            memcpy (&batch, data, sizeof (JemuGameCoreBatch));
+
+        memset (&state, 0, sizeof (JemuGameCoreState));
+        if (const void* data = desc.extension (JEMU_GAME_CORE_STATE))
+            memcpy (&state, data, sizeof (JemuGameCoreState));
+
+        memset (&idle, 0, sizeof (JemuGameCoreIdle));
+        if (const void* data = desc.extension (JEMU_GAME_CORE_IDLE))
+            memcpy (&idle, data, sizeof (JemuGameCoreIdle));
+
+        // older plugins have no caps, or a smaller struct than this header's
+        memset (&caps, 0, sizeof (JemuGameCoreCaps));
+        if (const auto* data = static_cast<const JemuGameCoreCaps*> (desc.extension (JEMU_GAME_CORE_CAPS)))
+            memcpy (&caps, data, jmin ((size_t) data->size, sizeof (JemuGameCoreCaps)));
     }
 
     ~GameCoreInstance() noexcept
@@ -80,6 +157,15 @@ public:
         }
     }
 
+    /** The plugin's capabilities, all zero if it doesn't report any */
+    const JemuGameCoreCaps& getCapabilities() const { return caps; }
+
+    /** True if the plugin's entry points are bound at compile time */
+    bool hasDirectDispatch() const
+    {
+        return caps.version >= 1 && (caps.flags & JEMU_CAP_DIRECT_DISPATCH) != 0;
+    }
+
     void prepare()      override { if (core.prepare != nullptr)  core.prepare (handle); }
     void release()      override { if (core.release != nullptr)  core.release (handle); }
     void reset()        override { if (core.reset != nullptr)    core.reset (handle); }
@@ -95,6 +181,62 @@ public:
                                            : nullptr; 
     }
 
+    double getFrameRate() const override
+    {
+        return timing.frame_rate != nullptr ? timing.frame_rate (handle)
+                                            : GameCore::getFrameRate();
+    }
+
+    double getSampleRate() const override
+    {
+        return timing.sample_rate != nullptr ? timing.sample_rate (handle)
+                                             : GameCore::getSampleRate();
+    }
+
+    void setOutputSampleRate (double rate) override
+    {
+        if (audio.set_output_rate != nullptr)
+            audio.set_output_rate (handle, rate);
+    }
+
+    bool setFrameBuffers (const JemuVideoFormat& format, void* const* buffers) override
+    {
+        return video.set_frame_buffers != nullptr
+            && video.set_frame_buffers (handle, &format, buffers);
+    }
+
+    int acquireFrame() override
+    {
+        return video.acquire_frame != nullptr ? video.acquire_frame (handle) : -1;
+    }
+
+    uint32_t runFrames (uint32_t count, const JemuInputFrame* inputs, uint32_t flags) override
+    {
+        return batch.run_frames != nullptr ? batch.run_frames (handle, count, inputs, flags)
+                                           : GameCore::runFrames (count, inputs, flags);
+    }
+
+    uint32_t getStateSize() override
+    {
+        return state.state_size != nullptr ? state.state_size (handle) : 0;
+    }
+
+    uint32_t saveStateInto (void* buffer, uint32_t size) override
+    {
+        return state.save_state_into != nullptr ? state.save_state_into (handle, buffer, size) : 0;
+    }
+
+    bool loadStateFrom (const void* buffer, uint32_t size) override
+    {
+        return state.load_state_from != nullptr && state.load_state_from (handle, buffer, size);
+    }
+
+    void setIdleSkip (bool enabled) override
+    {
+        if (idle.set_idle_skip != nullptr)
+            idle.set_idle_skip (handle, enabled);
+    }
+
     void readAudio (float* out, const int nframes) override { 
         if (core.read_audio != nullptr) core.read_audio (handle, out, nframes); 
     }
@@ -106,6 +248,13 @@ public:
 private:
     const JemuDescriptor desc;
     JemuGameCore core;
+    JemuGameCoreTiming timing;
+    JemuGameCoreAudio audio;
+    JemuGameCoreVideo video;
+    JemuGameCoreBatch batch;
+    JemuGameCoreState state;
+    JemuGameCoreIdle idle;
+    JemuGameCoreCaps caps;
     JemuHandle handle;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GameCoreInstance);
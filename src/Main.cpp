@@ -16,10 +16,14 @@
     Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 */
 
+#include <atomic>
+#include <jemu/epoch.h>
 #include <jemu/plugin.h>
 #include "MainComponent.h"
 #include "GameCore.h"
 #include "GamePad.h"
+#include "FrameImage.h"
+#include "PluginBundle.h"
 
 #define DEFAULT_GAME "/path/to/game.nes"
 
@@ -39,124 +43,54 @@ static String getPluginBundlePath (const String& name)
    #endif
 }
 
-class PluginBundle
+class GamePlayEngine : private HighResolutionTimer,
+                       public AudioIODeviceCallback,
+                       public GamePadManager::Listener
 {
 public:
-    PluginBundle (const String& _bundlePath)
-        : bundlePath (_bundlePath)
-    { }
-
-    static const String binaryExtension()
-    {
-       #if JUCE_MAC
-        return ".dylib";
-       #elif JUCE_WINDOWS
-        return ".dll";
-       #elif JUCE_LINUX
-        return ".so";
-       #endif
-    }
-
-    bool isOpen() const { return libraryOpen; }
-
-    bool open()
-    {
-        close();
-        if (! libraryOpen)
-        {
-            DBG("[emu] open plugin: " << File(bundlePath).getFileName());
-            DBG("[emu] " << bundlePath);
-            File libraryFile (bundlePath);
-            String fileName = libraryFile.getFileNameWithoutExtension(); 
-            fileName << binaryExtension();
-            libraryFile = libraryFile.getChildFile (fileName);
-            libraryOpen = library.open (libraryFile.getFullPathName().toRawUTF8());
-            if (libraryOpen)
-            {
-                uint32 i = 0; 
-                for (;;)
-                {
-                    if (const auto* desc = getDescriptor (i))
-                        descriptors.add (desc);
-                    else
-                        break;
-                    ++i;
-                }
-            }
-        }
-
-        return libraryOpen;
-    }
-
-    void close()
-    {
-        if (! libraryOpen)
-            return;
-        libraryOpen = false;
-        descriptors.clearQuick();
-        library.close();        
-    }
-
-    GameCoreInstance* instantiateGameCore (const String& identifier)
-    {
-        if (! isOpen())
-            return nullptr;
-
-        for (const auto* desc : descriptors)
-            if (strcmp (identifier.toRawUTF8(), desc->ID) == 0)
-                return createGameCore (desc);
-
-        return nullptr;
-    }
-
-private:
-    const String bundlePath;
-    DynamicLibrary library;
-    bool libraryOpen;
-    Array<const JemuDescriptor*> descriptors;
-    JemuDescriptorFunction descriptorFunction = nullptr;
-
-    GameCoreInstance* createGameCore (const JemuDescriptor* desc)
+    /** What decides when the next frame is emulated */
+    enum class Pacing
     {
-        jassert (desc != nullptr && desc->instantiate != nullptr && desc->extension != nullptr);
-        if (desc == nullptr || desc->instantiate == nullptr || desc->extension == nullptr)
-            return nullptr;
-        if (JemuHandle instance = desc->instantiate (bundlePath.toRawUTF8()))
-            return new GameCoreInstance (desc, instance);
-        return nullptr;
-    }
+        /** The wall clock, at the core's own frame rate */
+        timer,
 
-    GamePadSource* createGamePadSource (const JemuDescriptor* desc) {
-        return nullptr;
-    }
+        /** Samples consumed by the audio device. Falls back to the wall
+            clock while no device is running */
+        audioClock
+    };
 
-    const JemuDescriptor* getDescriptor (const uint32 index)
+    GamePlayEngine() { videoImage = Image (Image::PixelFormat::RGB, 256, 240, true); }
+    ~GamePlayEngine() noexcept
     {
-        if (descriptorFunction == nullptr)
-            descriptorFunction = (JemuDescriptorFunction) library.getFunction ("jemu_descriptor");
-        return descriptorFunction != nullptr ? descriptorFunction (index) : nullptr;
+        stopTimer();
+        audioCore.exchange (nullptr);
     }
-};
-
-class GamePlayEngine : private HighResolutionTimer,
-                       public AudioIODeviceCallback,
-                       public GamePadManager::Listener
-{
-public:
-    GamePlayEngine() { videoImage = Image (Image::PixelFormat::RGB, 256, 240, true); }
-    ~GamePlayEngine() noexcept { stopTimer(); }
 
     void loadPlugin (const String& name)
     {
         const bool wasRunning = isTimerRunning();
         stop();
 
+        // take the core away from the audio thread and wait until it lets
+        // go of it before destroying anything
+        audioCore.exchange (nullptr);
+
         width = height = 0;
-        core.reset (nullptr);
+        useHostFrames = false;
+        {
+            ScopedLock sl (coreLock);
+            core.reset (nullptr);
+        }
         bundle.reset (new PluginBundle (getPluginBundlePath (name)));
 
         if (bundle != nullptr && bundle->open())
+        {
+            // the device may be running at a rate other than the core's
+            ScopedLock sl (coreLock);
             core.reset (bundle->instantiateGameCore (JEMU_NESTOPIA));
+            if (core != nullptr)
+                core->setOutputSampleRate (deviceSampleRate.load (std::memory_order_relaxed));
+        }
 
         if (core != nullptr)
         {
@@ -164,8 +98,10 @@ public:
             width = core->getWidth();
             height = core->getHeight();
             videoImage = Image (Image::PixelFormat::RGB, width, height, true);
+            useHostFrames = setupHostFrames();
             if (core->load (DEFAULT_GAME))
                 core->reset();
+            audioCore.exchange (core.get());
         }
 
         if (wasRunning)
@@ -176,7 +112,19 @@ public:
     {
         if (isTimerRunning())
             stop();
-        startTimer (1000 / 60);
+        {
+            ScopedLock sl (coreLock);
+            resetPacing();
+        }
+        startTimer (1);
+    }
+
+    /** Change how frames are paced. Takes effect on the next timer tick */
+    void setPacing (const Pacing newPacing)
+    {
+        ScopedLock sl (coreLock);
+        pacing = newPacing;
+        resetPacing();
     }
 
     void stop() { stopTimer(); }
@@ -197,6 +145,30 @@ public:
         core->buttonPress (button, false);
     }
 
+    /** Called on the message thread to get the latest frame into image.
+        With host frames this only swaps image for the newest frame the core
+        published, otherwise the frame is copied. Returns false if there's
+        nothing new to show. */
+    bool acquireVideoFrame (Image& image)
+    {
+        if (useHostFrames)
+        {
+            const int index = core->acquireFrame();
+            if (! isPositiveAndBelow (index, numHostFrames))
+                return false;
+            image = hostFrames [index];
+            return true;
+        }
+
+        // start over if image is one of a previous core's host frames
+        if (! image.isValid() || dynamic_cast<FramePixelData*> (image.getPixelData()) != nullptr)
+            image = createImageTemplate();
+        if (image.isNull() || !image.isValid())
+            return false;
+        copyVideoImage (image);
+        return true;
+    }
+
     void copyVideoImage (Image image)
     {
         ScopedLock sl (coreLock);
@@ -218,33 +190,46 @@ public:
     void audioDeviceIOCallback (const float** inputs, int numInputs, 
                                 float** outputs, int numOutputs, int numSamples) override
     {
-        bool haveCore = false;
-
-        {
-            ScopedLock sl (coreLock);
-            haveCore = core != nullptr;
-        }
+        // real-time thread: never take coreLock here. The core only reads
+        // from its lock-free audio ring and stays alive for this scope
+        jemu::EpochPointer<GameCoreInstance>::ReadScope scope (audioCore);
+        GameCoreInstance* const audioSource = scope.get();
 
         for (int channel = 0; channel < numOutputs; ++channel)
         {
-            // FloatVectorOperations::clear (outputs[channel], numSamples);
-            if (! haveCore)
-                continue;
-
-            if (channel == 0)
+            if (audioSource == nullptr)
+            {
+                FloatVectorOperations::clear (outputs[channel], numSamples);
+            }
+            else if (channel == 0)
             {
-                core->readAudio (outputs [channel], numSamples);
+                audioSource->readAudio (outputs [channel], numSamples);
             }
             else
             {
                 FloatVectorOperations::copy (outputs[channel], outputs[0], numSamples);
             }
         }
+
+        samplesConsumed.fetch_add (static_cast<uint64> (numSamples), std::memory_order_relaxed);
     }
 
-    void audioDeviceAboutToStart (AudioIODevice* device) override { }
+    void audioDeviceAboutToStart (AudioIODevice* device) override
+    {
+        {
+            ScopedLock sl (coreLock);
+            deviceSampleRate.store (device->getCurrentSampleRate(), std::memory_order_relaxed);
+            if (core != nullptr)
+                core->setOutputSampleRate (device->getCurrentSampleRate());
+        }
 
-    void audioDeviceStopped() override { }
+        audioRunning.store (true, std::memory_order_release);
+    }
+
+    void audioDeviceStopped() override
+    {
+        audioRunning.store (false, std::memory_order_release);
+    }
 
     void audioDeviceError (const String& errorMessage) override
     {
@@ -253,38 +238,123 @@ public:
 
 private:
     std::unique_ptr<PluginBundle> bundle;
-    std::unique_ptr<GameCore> core;
+    std::unique_ptr<GameCoreInstance> core;
+    jemu::EpochPointer<GameCoreInstance> audioCore;
     CriticalSection coreLock;
     Image videoImage;
 
+    enum { numHostFrames = 3 };
+    Image hostFrames [numHostFrames];
+    bool useHostFrames = false;
+
     int width = 0;
     int height = 0;
 
+    // frames to stay ahead of the audio device, about half the core's ring
+    enum { audioLeadFrames = 2, maxCatchUpFrames = 4 };
+
+    Pacing pacing = Pacing::audioClock;
+    bool pacedByAudio = false;
+    int64 framesSinceAnchor = 0;
+    uint64 samplesAtAnchor = 0;
+    double msAtAnchor = 0.0;
+    std::atomic<uint64> samplesConsumed { 0 };
+    std::atomic<double> deviceSampleRate { 0.0 };
+    std::atomic<bool> audioRunning { false };
+
+    /** Restart frame accounting from now on the current clock */
+    void resetPacing()
+    {
+        framesSinceAnchor = 0;
+        samplesAtAnchor = samplesConsumed.load (std::memory_order_relaxed);
+        msAtAnchor = Time::getMillisecondCounterHiRes();
+    }
+
+    /** Frames that should have been emulated since the anchor */
+    double getFramesDue (const double frameRate)
+    {
+        const bool useAudio = pacing == Pacing::audioClock
+            && audioRunning.load (std::memory_order_acquire)
+            && deviceSampleRate.load (std::memory_order_relaxed) > 0.0;
+
+        if (useAudio != pacedByAudio)
+        {
+            pacedByAudio = useAudio;
+            resetPacing();
+        }
+
+        if (pacedByAudio)
+        {
+            const uint64 samples = samplesConsumed.load (std::memory_order_relaxed) - samplesAtAnchor;
+            return audioLeadFrames + (double) samples * frameRate
+                / deviceSampleRate.load (std::memory_order_relaxed);
+        }
+
+        return 1.0 + (Time::getMillisecondCounterHiRes() - msAtAnchor) * 0.001 * frameRate;
+    }
+
     friend class HighResolutionTimer;
     void hiResTimerCallback() override
     {
         ScopedLock sl (coreLock);
         if (nullptr == core)
             return;
-        core->tick();
-        renderImage (core.get());
+
+        const double framesDue = getFramesDue (core->getFrameRate());
+        const int framesRun = jlimit (0, (int) maxCatchUpFrames,
+                                      (int) std::ceil (framesDue - (double) framesSinceAnchor));
+
+        // only the newest frame is ever displayed, so catch-up frames skip video
+        if (framesRun > 0)
+            framesSinceAnchor += core->runFrames ((uint32) framesRun, nullptr, JEMU_RUN_SKIP_VIDEO);
+
+        // hopelessly behind (debugger, suspended device...) so don't try
+        // to catch up with a burst of frames
+        if (framesSinceAnchor + maxCatchUpFrames < framesDue)
+            resetPacing();
+
+        if (framesRun > 0 && ! useHostFrames)
+            renderImage (core.get());
     }
 
-    void renderImage (GameCore* c)
+    /** Give the core three frames to render into, so video reaches the
+        display without copies. Returns false if the core can't */
+    bool setupHostFrames()
+    {
+        void* buffers [numHostFrames];
+        for (int i = 0; i < numHostFrames; ++i)
+        {
+            hostFrames[i] = FramePixelData::createImage (width, height);
+            buffers[i] = FramePixelData::getFrameData (hostFrames[i]);
+        }
+
+        if (core->setFrameBuffers (FramePixelData::getVideoFormat (hostFrames[0]), buffers))
+            return true;
+
+        for (auto& frame : hostFrames)
+            frame = Image();
+        return false;
+    }
+
+    void renderImage (GameCoreInstance* c)
     {
         const uint8* buffer = (const uint8*) c->getVideoBuffer();
         if (videoImage.isNull() || !videoImage.isValid())
             return;
-        Image::BitmapData bitmap (videoImage, Image::BitmapData::readWrite);
-        
+        Image::BitmapData bitmap (videoImage, Image::BitmapData::writeOnly);
+
+        // the core's own buffer is XRGB8888, so one pass into the image's
+        // pixel layout, whatever its stride
         if (buffer != nullptr)
         {
-            for (int i = 0; i < bitmap.width * bitmap.height * 4; i += 4)
+            const uint32* src = reinterpret_cast<const uint32*> (buffer);
+
+            for (int y = 0; y < bitmap.height; ++y, src += bitmap.width)
             {
-                bitmap.data[i + 0] = buffer [i + 0];
-                bitmap.data[i + 1] = buffer [i + 1];
-                bitmap.data[i + 2] = buffer [i + 2];
-                bitmap.data[i + 3] = 255;
+                uint8* dst = bitmap.getLinePointer (y);
+
+                for (int x = 0; x < bitmap.width; ++x, dst += bitmap.pixelStride)
+                    reinterpret_cast<PixelRGB*> (dst)->setARGB (0xff, (uint8) (src[x] >> 16), (uint8) (src[x] >> 8), (uint8) src[x]);
             }
         }
     }
@@ -353,12 +423,8 @@ public:
 
     void update()
     {
-        if (videoImage.isNull() || !videoImage.isValid())
-            videoImage = engine.createImageTemplate();
-        if (videoImage.isNull() || !videoImage.isValid())
-            return;
-        engine.copyVideoImage (videoImage);
-        repaint();
+        if (engine.acquireVideoFrame (videoImage))
+            repaint();
     }
 
     bool keyPressed (const KeyPress& key) override
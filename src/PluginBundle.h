@@ -0,0 +1,123 @@
+/*
+    This file is part of Jemu
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#pragma once
+
+#include <jemu/plugin.h>
+#include "GameCore.h"
+#include "GamePad.h"
+
+/** Loads a plugin bundle and instantiates the game cores it provides */
+class PluginBundle
+{
+public:
+    PluginBundle (const String& _bundlePath)
+        : bundlePath (_bundlePath)
+    { }
+
+    static const String binaryExtension()
+    {
+       #if JUCE_MAC
+        return ".dylib";
+       #elif JUCE_WINDOWS
+        return ".dll";
+       #elif JUCE_LINUX
+        return ".so";
+       #endif
+    }
+
+    bool isOpen() const { return libraryOpen; }
+
+    bool open()
+    {
+        close();
+        if (! libraryOpen)
+        {
+            DBG("[emu] open plugin: " << File(bundlePath).getFileName());
+            DBG("[emu] " << bundlePath);
+            File libraryFile (bundlePath);
+            String fileName = libraryFile.getFileNameWithoutExtension(); 
+            fileName << binaryExtension();
+            libraryFile = libraryFile.getChildFile (fileName);
+            libraryOpen = library.open (libraryFile.getFullPathName().toRawUTF8());
+            if (libraryOpen)
+            {
+                uint32 i = 0; 
+                for (;;)
+                {
+                    if (const auto* desc = getDescriptor (i))
+                        descriptors.add (desc);
+                    else
+                        break;
+                    ++i;
+                }
+            }
+        }
+
+        return libraryOpen;
+    }
+
+    void close()
+    {
+        if (! libraryOpen)
+            return;
+        libraryOpen = false;
+        descriptors.clearQuick();
+        library.close();        
+    }
+
+    GameCoreInstance* instantiateGameCore (const String& identifier)
+    {
+        if (! isOpen())
+            return nullptr;
+
+        for (const auto* desc : descriptors)
+            if (strcmp (identifier.toRawUTF8(), desc->ID) == 0)
+                return createGameCore (desc);
+
+        return nullptr;
+    }
+
+private:
+    const String bundlePath;
+    DynamicLibrary library;
+    bool libraryOpen = false;
+    Array<const JemuDescriptor*> descriptors;
+    JemuDescriptorFunction descriptorFunction = nullptr;
+
+    GameCoreInstance* createGameCore (const JemuDescriptor* desc)
+    {
+        jassert (desc != nullptr && desc->instantiate != nullptr && desc->extension != nullptr);
+        if (desc == nullptr || desc->instantiate == nullptr || desc->extension == nullptr)
+            return nullptr;
+        if (JemuHandle instance = desc->instantiate (bundlePath.toRawUTF8()))
+            return new GameCoreInstance (desc, instance);
+        return nullptr;
+    }
+
+    GamePadSource* createGamePadSource (const JemuDescriptor* desc) {
+        return nullptr;
+    }
+
+    const JemuDescriptor* getDescriptor (const uint32 index)
+    {
+        if (descriptorFunction == nullptr)
+            descriptorFunction = (JemuDescriptorFunction) library.getFunction ("jemu_descriptor");
+        return descriptorFunction != nullptr ? descriptorFunction (index) : nullptr;
+    }
+};
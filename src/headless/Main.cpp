@@ -0,0 +1,375 @@
+/*
+    This file is part of Jemu
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/*
+    Headless runner.  Loads a plugin bundle, boots a rom and ticks the
+    core as fast as possible with no display or audio device attached.
+
+    jemu-headless [options] <rom>
+        --bundle <path>     plugin bundle (default: ../lib/jemu/nestopia.jemu)
+        --core <id>         game core identifier (default: org.jemu.Nestopia)
+        --frames <n>        frames to measure (default: 3600)
+        --warmup <n>        frames to run before measuring (default: 60)
+        --audio             drain audio every frame like the device callback would
+        --video             fetch the video frame every frame
+        --batch <n>         emulate n frames per run_frames call (default: 1). Frames
+                            before the last skip video, and audio unless --audio
+        --instances <n>     run n copies of the rom on the engine's thread pool and
+                            report aggregate fps and per-instance lag (default: 1)
+        --threads <n>       engine worker threads (default: one per hardware thread)
+        --realtime          pace engine instances at their frame rate instead of
+                            running them as fast as possible
+        --states            save and reload an in-memory state after every measured
+                            step, like run-ahead would, and report the round trip cost
+        --idle-skip         let the core run ahead through idle loops, see JemuGameCoreIdle
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <sys/resource.h>
+#endif
+
+#include "Engine.h"
+#include "PluginBundle.h"
+
+#define HEADLESS_SAMPLERATE 48000
+
+namespace {
+
+struct Options
+{
+    String bundlePath;
+    String coreID       = JEMU_NESTOPIA;
+    String romPath;
+    int frames          = 3600;
+    int warmup          = 60;
+    int batch           = 1;
+    int instances       = 1;
+    int threads         = 0;
+    bool drainAudio     = false;
+    bool fetchVideo     = false;
+    bool realtime       = false;
+    bool saveStates     = false;
+    bool idleSkip       = false;
+};
+
+String getDefaultBundlePath()
+{
+    return File::getSpecialLocation (File::invokedExecutableFile)
+        .getParentDirectory().getParentDirectory()
+        .getChildFile ("lib/jemu/nestopia.jemu")
+        .getFullPathName();
+}
+
+void printUsage()
+{
+    std::fprintf (stderr, "usage: jemu-headless [--bundle path] [--core id] [--frames n] "
+                          "[--warmup n] [--audio] [--video] [--batch n] "
+                          "[--instances n] [--threads n] [--realtime] [--states] [--idle-skip] <rom>\n");
+}
+
+bool parseOptions (int argc, char* argv[], Options& opts)
+{
+    opts.bundlePath = getDefaultBundlePath();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg (argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--bundle" && hasValue)
+            opts.bundlePath = File::getCurrentWorkingDirectory()
+                .getChildFile (argv[++i]).getFullPathName();
+        else if (arg == "--core" && hasValue)
+            opts.coreID = argv[++i];
+        else if (arg == "--frames" && hasValue)
+            opts.frames = String (argv[++i]).getIntValue();
+        else if (arg == "--warmup" && hasValue)
+            opts.warmup = String (argv[++i]).getIntValue();
+        else if (arg == "--batch" && hasValue)
+            opts.batch = String (argv[++i]).getIntValue();
+        else if (arg == "--instances" && hasValue)
+            opts.instances = String (argv[++i]).getIntValue();
+        else if (arg == "--threads" && hasValue)
+            opts.threads = String (argv[++i]).getIntValue();
+        else if (arg == "--realtime")
+            opts.realtime = true;
+        else if (arg == "--states")
+            opts.saveStates = true;
+        else if (arg == "--idle-skip")
+            opts.idleSkip = true;
+        else if (arg == "--audio")
+            opts.drainAudio = true;
+        else if (arg == "--video")
+            opts.fetchVideo = true;
+        else if (arg.startsWith ("--"))
+            return false;
+        else
+            opts.romPath = File::getCurrentWorkingDirectory()
+                .getChildFile (arg).getFullPathName();
+    }
+
+    return opts.romPath.isNotEmpty() && opts.frames > 0 && opts.warmup >= 0
+        && opts.batch > 0 && opts.instances > 0 && opts.threads >= 0;
+}
+
+/** Peak resident set size in bytes, or 0 if unknown */
+int64 getPeakResidentBytes()
+{
+   #if JUCE_LINUX
+    struct rusage usage;
+    if (getrusage (RUSAGE_SELF, &usage) == 0)
+        return static_cast<int64> (usage.ru_maxrss) * 1024;
+   #elif JUCE_MAC
+    struct rusage usage;
+    if (getrusage (RUSAGE_SELF, &usage) == 0)
+        return static_cast<int64> (usage.ru_maxrss);
+   #endif
+    return 0;
+}
+
+int64 percentile (const std::vector<int64>& sorted, const double p)
+{
+    if (sorted.empty())
+        return 0;
+    const auto index = static_cast<size_t> (p * (sorted.size() - 1) + 0.5);
+    return sorted [jmin (index, sorted.size() - 1)];
+}
+
+uint32 getRunFlags (const Options& opts)
+{
+    uint32 flags = 0;
+    if (! opts.fetchVideo)
+        flags |= JEMU_RUN_SKIP_VIDEO;
+    if (! opts.drainAudio)
+        flags |= JEMU_RUN_SKIP_AUDIO;
+    return flags;
+}
+
+/** Runs opts.instances cores on an Engine until each has run opts.frames
+    frames past warmup. Audio is rendered with --audio but not drained */
+int runEngine (PluginBundle& bundle, const Options& opts)
+{
+    Engine engine (opts.threads);
+    Engine::InstanceOptions instanceOpts;
+    instanceOpts.runFlags = getRunFlags (opts);
+
+    for (int i = 0; i < opts.instances; ++i)
+    {
+        std::unique_ptr<GameCoreInstance> core (bundle.instantiateGameCore (opts.coreID));
+        if (core == nullptr)
+        {
+            std::fprintf (stderr, "[headless] no game core '%s' in bundle\n", opts.coreID.toRawUTF8());
+            return 1;
+        }
+
+        core->prepare();
+        if (! core->load (opts.romPath.toRawUTF8()))
+        {
+            std::fprintf (stderr, "[headless] could not load rom: %s\n", opts.romPath.toRawUTF8());
+            core->release();
+            return 1;
+        }
+        core->reset();
+        core->setIdleSkip (opts.idleSkip);
+        engine.addInstance (core.release(), instanceOpts);
+    }
+
+    const uint64 warmupFrames = (uint64) opts.warmup * opts.instances;
+    const uint64 targetFrames = warmupFrames + (uint64) opts.frames * opts.instances;
+    auto waitForFrames = [&engine] (const uint64 total) {
+        while (engine.getStats().totalFrames < total)
+            std::this_thread::sleep_for (std::chrono::milliseconds (10));
+    };
+
+    engine.setThroughputMode (! opts.realtime);
+    engine.start();
+    waitForFrames (warmupFrames);
+
+    typedef std::chrono::steady_clock Clock;
+    const uint64 framesBefore = engine.getStats().totalFrames;
+    const auto started = Clock::now();
+    waitForFrames (targetFrames);
+    const Engine::Stats stats = engine.getStats();
+    const double elapsed = std::chrono::duration<double> (Clock::now() - started).count();
+    engine.stop();
+
+    for (int i = 0; i < engine.getNumInstances(); ++i)
+        engine.getInstance (i)->release();
+
+    const uint64 framesMeasured = stats.totalFrames - framesBefore;
+    std::printf ("core:        %s\n", opts.coreID.toRawUTF8());
+    std::printf ("rom:         %s\n", opts.romPath.toRawUTF8());
+    std::printf ("engine:      %d instances, %d threads, %s\n", opts.instances,
+                 engine.getNumWorkers(), opts.realtime ? "realtime" : "throughput");
+    std::printf ("idle skip:   %s\n", opts.idleSkip ? "on" : "off");
+    std::printf ("frames:      %llu (warmup %d per instance)\n", (unsigned long long) framesMeasured, opts.warmup);
+    std::printf ("elapsed:     %.3f s\n", elapsed);
+    std::printf ("fps:         %.1f aggregate, %.1f per instance\n",
+                 elapsed > 0.0 ? framesMeasured / elapsed : 0.0,
+                 elapsed > 0.0 ? framesMeasured / elapsed / opts.instances : 0.0);
+    std::printf ("steals:      %llu\n", (unsigned long long) stats.steals);
+
+    for (size_t i = 0; i < stats.instances.size(); ++i)
+    {
+        const auto& instance = stats.instances[i];
+        std::printf ("instance %-3d frames %-8llu behind %6.2f  lag %7.3f ms  max %7.3f ms  worker %d\n",
+                     (int) i, (unsigned long long) instance.frames, instance.framesBehind,
+                     instance.lagMs, instance.maxLagMs, instance.worker);
+    }
+
+    std::printf ("peak rss:    %.1f MiB\n", getPeakResidentBytes() / (1024.0 * 1024.0));
+    return 0;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    Options opts;
+    if (! parseOptions (argc, argv, opts))
+    {
+        printUsage();
+        return 1;
+    }
+
+    PluginBundle bundle (opts.bundlePath);
+    if (! bundle.open())
+    {
+        std::fprintf (stderr, "[headless] could not open bundle: %s\n", opts.bundlePath.toRawUTF8());
+        return 1;
+    }
+
+    if (opts.instances > 1 || opts.threads > 0 || opts.realtime)
+    {
+        if (opts.saveStates)
+        {
+            std::fprintf (stderr, "[headless] --states can't be combined with "
+                                  "--instances, --threads or --realtime\n");
+            return 1;
+        }
+
+        return runEngine (bundle, opts);
+    }
+
+    std::unique_ptr<GameCoreInstance> core (bundle.instantiateGameCore (opts.coreID));
+    if (core == nullptr)
+    {
+        std::fprintf (stderr, "[headless] no game core '%s' in bundle\n", opts.coreID.toRawUTF8());
+        return 1;
+    }
+
+    core->prepare();
+    if (! core->load (opts.romPath.toRawUTF8()))
+    {
+        std::fprintf (stderr, "[headless] could not load rom: %s\n", opts.romPath.toRawUTF8());
+        core->release();
+        return 1;
+    }
+    core->reset();
+    core->setIdleSkip (opts.idleSkip);
+
+    // one frame worth of audio at the rate the host device would run at
+    const int samplesPerFrame = HEADLESS_SAMPLERATE / 60;
+    HeapBlock<float> audio (samplesPerFrame * opts.batch, true);
+
+    const uint32 runFlags = getRunFlags (opts);
+
+    auto step = [&]() {
+        if (opts.batch > 1)
+            core->runFrames ((uint32) opts.batch, nullptr, runFlags);
+        else
+            core->tick();
+        if (opts.drainAudio)
+            core->readAudio (audio.getData(), samplesPerFrame * opts.batch);
+        if (opts.fetchVideo)
+            core->getVideoBuffer();
+    };
+
+    const int warmupSteps = (opts.warmup + opts.batch - 1) / opts.batch;
+    const int steps = (opts.frames + opts.batch - 1) / opts.batch;
+    const int framesMeasured = steps * opts.batch;
+    for (int i = 0; i < warmupSteps; ++i)
+        step();
+
+    typedef std::chrono::steady_clock Clock;
+    std::vector<int64> frameTimes;
+    frameTimes.reserve (static_cast<size_t> (steps));
+
+    // one arena for every save, sized by the first
+    MemoryBlock stateArena;
+    uint32 stateSize = 0;
+    std::vector<int64> stateTimes;
+    stateTimes.reserve (opts.saveStates ? static_cast<size_t> (steps) : 0);
+
+    const auto started = Clock::now();
+    for (int i = 0; i < steps; ++i)
+    {
+        const auto frameStart = Clock::now();
+        step();
+        frameTimes.push_back (std::chrono::duration_cast<std::chrono::nanoseconds> (
+            Clock::now() - frameStart).count() / opts.batch);
+
+        if (opts.saveStates)
+        {
+            const auto stateStart = Clock::now();
+            stateSize = core->saveState (stateArena);
+            if (stateSize == 0 || ! core->loadStateFrom (stateArena.getData(), stateSize))
+            {
+                std::fprintf (stderr, "[headless] core can't round trip states\n");
+                core->release();
+                return 1;
+            }
+            stateTimes.push_back (std::chrono::duration_cast<std::chrono::nanoseconds> (
+                Clock::now() - stateStart).count());
+        }
+    }
+    const double elapsed = std::chrono::duration<double> (Clock::now() - started).count();
+
+    core->release();
+
+    std::sort (frameTimes.begin(), frameTimes.end());
+    std::printf ("core:        %s\n", opts.coreID.toRawUTF8());
+    std::printf ("rom:         %s\n", opts.romPath.toRawUTF8());
+    std::printf ("dispatch:    %s\n", core->hasDirectDispatch() ? "direct" : "checked");
+    std::printf ("idle skip:   %s\n", opts.idleSkip ? "on" : "off");
+    std::printf ("frames:      %d (warmup %d, batch %d)\n", framesMeasured, opts.warmup, opts.batch);
+    std::printf ("elapsed:     %.3f s\n", elapsed);
+    std::printf ("fps:         %.1f\n", elapsed > 0.0 ? framesMeasured / elapsed : 0.0);
+    std::printf ("ns/frame:    p50 %lld  p90 %lld  p99 %lld  max %lld\n",
+                 (long long) percentile (frameTimes, 0.50),
+                 (long long) percentile (frameTimes, 0.90),
+                 (long long) percentile (frameTimes, 0.99),
+                 (long long) frameTimes.back());
+    if (opts.saveStates)
+    {
+        std::sort (stateTimes.begin(), stateTimes.end());
+        std::printf ("states:      %u bytes, ns/round trip p50 %lld  p99 %lld  max %lld\n",
+                     (unsigned) stateSize,
+                     (long long) percentile (stateTimes, 0.50),
+                     (long long) percentile (stateTimes, 0.99),
+                     (long long) stateTimes.back());
+    }
+    std::printf ("peak rss:    %.1f MiB\n", getPeakResidentBytes() / (1024.0 * 1024.0));
+
+    return 0;
+}